@@ -34,7 +34,15 @@ namespace lsp
         {
             static constexpr float  HISTORY_TIME            = 4.0f;     // Amount of time to display history [s]
             static constexpr size_t HISTORY_MESH_SIZE       = 560;      // 420 dots for history
+            static constexpr size_t HISTORY_STREAM_FRAMES   = 0x100;    // Number of frames kept by the history stream
+            static constexpr size_t HISTORY_STREAM_SIZE     = HISTORY_MESH_SIZE * 4;    // Number of dots kept by the history stream
+            static constexpr size_t HISTORY_LEVELS          = 7;        // Number of levels of history, the last one covers 64x history time
             static constexpr size_t OVERSAMPLING_MAX        = 8;        // Maximum 8x oversampling
+            static constexpr size_t CHANNELS_MAX            = 12;       // Maximum number of channels (7.1.4)
+            static constexpr size_t LFE_CHANNEL             = 3;        // Index of the LFE channel for surround layouts
+            static constexpr size_t TELEMETRY_FRAMES        = 0x100;    // Number of frames kept by the telemetry stream
+            static constexpr size_t TELEMETRY_SIZE          = TELEMETRY_FRAMES * CHANNELS_MAX;    // Number of values kept by the telemetry stream
+            static constexpr size_t TELEMETRY_POS_SPLIT     = 0x1000000;    // Position is split into two parts that are exactly represented by float
 
             static constexpr float  LOOKAHEAD_MIN           = 0.1f;     // No lookahead [ms]
             static constexpr float  LOOKAHEAD_MAX           = 20.0f;    // Maximum Lookahead [ms]
@@ -81,6 +89,11 @@ namespace lsp
             static constexpr float  LINKING_DFL             = 100.0f;
             static constexpr float  LINKING_STEP            = 0.01f;
 
+            static constexpr float  CPU_LOAD_MIN            = 0.0f;
+            static constexpr float  CPU_LOAD_MAX            = 100.0f;
+            static constexpr float  CPU_LOAD_DFL            = 0.0f;
+            static constexpr float  CPU_LOAD_STEP           = 0.1f;
+
             enum oversampling_mode_t
             {
                 OVS_NONE,
@@ -110,6 +123,14 @@ namespace lsp
                 OVS_TRUE_PEAK_16BIT,
                 OVS_TRUE_PEAK_24BIT,
 
+                OVS_LOW_LATENCY_2X,
+                OVS_LOW_LATENCY_4X,
+                OVS_LOW_LATENCY_8X,
+
+                OVS_SIDECHAIN_2X,
+                OVS_SIDECHAIN_4X,
+                OVS_SIDECHAIN_8X,
+
                 OVS_DEFAULT     = OVS_NONE
             };
 
@@ -147,12 +168,47 @@ namespace lsp
 
                 DITHER_DEFAULT  = DITHER_NONE
             };
+
+            enum history_span_t
+            {
+                HSPAN_4S,                       // History level 0
+                HSPAN_32S,                      // History level 3
+                HSPAN_64S,                      // History level 4
+                HSPAN_256S,                     // History level 6
+
+                HSPAN_DEFAULT   = HSPAN_4S
+            };
+
+            // Buffers of the telemetry stream, each frame describes one block and holds one value for each channel.
+            // The position and the length of the block are the same for all channels, the position of the first
+            // sample of the block is TLM_POS_HIGH * TELEMETRY_POS_SPLIT + TLM_POS_LOW
+            enum telemetry_buffer_t
+            {
+                TLM_IN_PEAK,                    // Peak input level
+                TLM_OUT_PEAK,                   // Peak output level
+                TLM_GAIN,                       // Minimum gain
+                TLM_FLAGS,                      // Telemetry flags
+                TLM_POS_HIGH,                   // High part of the position of the block in samples since the start of processing
+                TLM_POS_LOW,                    // Low part of the position of the block
+                TLM_LENGTH,                     // Length of the block in samples
+
+                TLM_BUFFERS
+            };
+
+            enum telemetry_flags_t
+            {
+                TF_ALR          = 1 << 0,       // Automatic level regulation reduces the gain of the channel
+                TF_BYPASS       = 1 << 1        // Plugin is bypassed
+            };
         };
 
         extern const meta::plugin_t limiter_mono;
         extern const meta::plugin_t limiter_stereo;
         extern const meta::plugin_t sc_limiter_mono;
         extern const meta::plugin_t sc_limiter_stereo;
+        extern const meta::plugin_t limiter_5_1;
+        extern const meta::plugin_t limiter_7_1;
+        extern const meta::plugin_t limiter_7_1_4;
     } // namespace meta
 } // namespace lsp
 
@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-limiter
+ * Created on: 17 окт. 2026 г.
+ *
+ * lsp-plugins-limiter is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-limiter is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-limiter. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_PLUGINS_HISTORY_H_
+#define PRIVATE_PLUGINS_HISTORY_H_
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/dsp-units/iface/IStateDumper.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        /**
+         * Multi-resolution history: a pyramid of rings of min/max dots. Each dot of the level
+         * covers two dots of the previous level, the level 0 stores dots as they are pushed.
+         * All levels have the same capacity, so the level N serves the history that is 2^N
+         * times longer than the level 0 with the same number of dots.
+         */
+        class HistoryStore
+        {
+            protected:
+                typedef struct level_t
+                {
+                    float          *vMin;           // Ring of minimums
+                    float          *vMax;           // Ring of maximums
+                    float           fMin;           // Minimum of the pending dot
+                    float           fMax;           // Maximum of the pending dot
+                    bool            bPending;       // Half of the next dot of the upper level is pending
+                } level_t;
+
+            protected:
+                level_t        *vLevels;            // List of levels
+                size_t          nLevels;            // Number of levels
+                size_t          nCapacity;          // Number of dots in each level
+                wsize_t         nDots;              // Number of dots pushed since the last clear
+                float           fDefault;           // Default value
+                uint8_t        *pData;              // Allocated data
+
+            public:
+                explicit HistoryStore();
+                HistoryStore(const HistoryStore &) = delete;
+                HistoryStore(HistoryStore &&) = delete;
+                ~HistoryStore();
+
+                HistoryStore & operator = (const HistoryStore &) = delete;
+                HistoryStore & operator = (HistoryStore &&) = delete;
+
+                /**
+                 * Initialize the history
+                 * @param levels number of levels
+                 * @param capacity number of dots in each level
+                 * @param dfl default value of dots
+                 * @return true on success
+                 */
+                bool            init(size_t levels, size_t capacity, float dfl);
+
+                /**
+                 * Destroy the history
+                 */
+                void            destroy();
+
+            public:
+                inline size_t   levels() const      { return nLevels;       }
+                inline size_t   capacity() const    { return nCapacity;     }
+                inline wsize_t  dots() const        { return nDots;         }
+
+                /**
+                 * Get number of complete dots of the level pushed since the last clear
+                 * @param level level
+                 * @return number of dots
+                 */
+                inline wsize_t  dots(size_t level) const    { return nDots >> level; }
+
+                /**
+                 * Reset all dots to the default value
+                 */
+                void            clear();
+
+                /**
+                 * Push new dots to the history, amortized complexity is O(1) per dot
+                 * @param src dots to push
+                 * @param count number of dots
+                 */
+                void            push(const float *src, size_t count);
+
+                /**
+                 * Read the last dots of the level, oldest dots go first
+                 * @param dst destination buffer
+                 * @param count number of dots to read, limited by capacity
+                 * @param level level to read
+                 * @param minimum read minimums instead of maximums
+                 */
+                void            read(float *dst, size_t count, size_t level, bool minimum) const;
+
+                /**
+                 * Dump the state
+                 * @param v state dumper
+                 */
+                void            dump(dspu::IStateDumper *v) const;
+        };
+
+    } /* namespace plugins */
+} /* namespace lsp */
+
+#endif /* PRIVATE_PLUGINS_HISTORY_H_ */
@@ -34,16 +34,48 @@
 #include <lsp-plug.in/dsp-units/util/Sidechain.h>
 
 #include <private/meta/limiter.h>
+#include <private/plugins/history.h>
 
 namespace lsp
 {
     namespace plugins
     {
+        /**
+         * Limiter that reports the state of its automatic level regulation
+         */
+        class ALRLimiter: public dspu::Limiter
+        {
+            public:
+                /**
+                 * Check that the automatic level regulation reduces the gain: the envelope of the
+                 * sidechain has reached the start of the knee
+                 * @return true if the automatic level regulation reduces the gain
+                 */
+                inline bool alr_active() const      { return (sALR.bEnable) && (sALR.fEnvelope >= sALR.fKS); }
+        };
+
         /**
          * Limiter Plugin Series
          */
         class limiter: public plug::Module
         {
+            public:
+                enum prof_stage_t
+                {
+                    PS_PREMIX,                                  // Pre-mix of audio channels
+                    PS_UPSAMPLE,                                // Input gain and upsampling of the signal
+                    PS_SIDECHAIN,                               // Pre-amplification, upsampling and decimation of the sidechain
+                    PS_LIMIT,                                   // Computation of the gain curve and delay of the signal
+                    PS_LINK,                                    // Linking of gain curves, includes limiters of fully linked groups
+                    PS_METERING,                                // Meters, graphs and telemetry
+                    PS_DOWNSAMPLE,                              // Application of the gain and downsampling
+                    PS_DITHER,                                  // Dithering
+                    PS_BYPASS,                                  // Dry delay and bypass
+                    PS_HISTORY,                                 // Telemetry, history and synchronization with UI
+
+                    PS_TOTAL
+                };
+
             protected:
                 enum sc_graph_t
                 {
@@ -62,6 +94,47 @@ namespace lsp
                     SCM_LINK,
                 };
 
+                enum param_id_t
+                {
+                    P_OVERSAMPLING,
+                    P_DITHERING,
+                    P_MODE,
+                    P_LOOKAHEAD,
+                    P_ATTACK,
+                    P_RELEASE,
+                    P_KNEE_LEVEL,
+                    P_KNEE_SMOOTH,
+                    P_ALR_ON,
+                    P_ALR_ATTACK,
+                    P_ALR_RELEASE,
+                    P_BOOST,
+                    P_LFE_LINK,
+                    P_GAIN_DECIM,
+
+                    P_TOTAL
+                };
+
+                enum update_t
+                {
+                    UPD_OVERSAMPLING    = 1 << 0,               // Oversampling, also requires update of limiter, delays and meters
+                    UPD_LIMITER         = 1 << 1,               // Limiter curve, timings and ALR
+                    UPD_DITHER          = 1 << 2,               // Dithering
+                    UPD_LINK            = 1 << 3,               // Gain linking groups
+
+                    UPD_ALL             = UPD_OVERSAMPLING | UPD_LIMITER | UPD_DITHER | UPD_LINK
+                };
+
+                enum idisplay_params_t
+                {
+                    IDISPLAY_LINES_MAX  = 16                    // Maximum number of grid lines of each direction
+                };
+
+                enum iir_params_t
+                {
+                    IIR_STAGES_MAX      = 3,                    // Maximum number of 2x stages of low-latency oversampler
+                    IIR_PATH_MAX        = 4                     // Maximum number of allpass sections in each polyphase path
+                };
+
                 typedef struct premix_t
                 {
                     float                   fInToSc;            // Input -> Sidechain mix
@@ -71,14 +144,14 @@ namespace lsp
                     float                   fScToIn;            // Sidechain -> Input mix
                     float                   fScToLink;          // Sidechain -> Link mix
 
-                    float                  *vIn[2];             // Input buffer
-                    float                  *vOut[2];            // Output buffer
-                    float                  *vSc[2];             // Sidechain buffer
-                    float                  *vLink[2];           // Link buffer
+                    float                  *vIn[meta::limiter_metadata::CHANNELS_MAX];      // Input buffer
+                    float                  *vOut[meta::limiter_metadata::CHANNELS_MAX];     // Output buffer
+                    float                  *vSc[meta::limiter_metadata::CHANNELS_MAX];      // Sidechain buffer
+                    float                  *vLink[meta::limiter_metadata::CHANNELS_MAX];    // Link buffer
 
-                    float                  *vTmpIn[2];          // Replacement buffer for input
-                    float                  *vTmpLink[2];        // Replacement buffer for link
-                    float                  *vTmpSc[2];          // Replacement buffer for sidechain
+                    float                  *vTmpIn[meta::limiter_metadata::CHANNELS_MAX];   // Replacement buffer for input
+                    float                  *vTmpLink[meta::limiter_metadata::CHANNELS_MAX]; // Replacement buffer for link
+                    float                  *vTmpSc[meta::limiter_metadata::CHANNELS_MAX];   // Replacement buffer for sidechain
 
                     plug::IPort            *pInToSc;            // Input -> Sidechain mix
                     plug::IPort            *pInToLink;          // Input -> Link mix
@@ -88,16 +161,47 @@ namespace lsp
                     plug::IPort            *pScToLink;          // Sidechain -> Link mix
                 } premix_t;
 
+                typedef struct idisplay_t
+                {
+                    size_t              nWidth;                     // Width of the inline display
+                    size_t              nHeight;                    // Height of the inline display
+                    float               fZy;                        // Normalizing factor of the level axis
+                    float               fDx;                        // Scale of the time axis
+                    float               fDy;                        // Scale of the level axis
+                    float               vVLines[IDISPLAY_LINES_MAX];// Coordinates of vertical grid lines
+                    float               vHLines[IDISPLAY_LINES_MAX];// Coordinates of horizontal grid lines
+                    uint32_t            nVLines;                    // Number of vertical grid lines
+                    uint32_t            nHLines;                    // Number of horizontal grid lines
+                    core::IDBuffer     *pBuffer;                    // Buffer that holds horizontal coordinates of history dots
+                } idisplay_t;
+
+                typedef struct iir_stage_t
+                {
+                    float               vUp[IIR_PATH_MAX * 4];      // Upsampler state: x[n-1] and y[n-1] of allpass sections of both paths
+                    float               vDown[IIR_PATH_MAX * 4];    // Downsampler state: x[n-1] and y[n-1] of allpass sections of both paths
+                } iir_stage_t;
+
                 typedef struct channel_t
                 {
                     dspu::Bypass        sBypass;            // Bypass
                     dspu::Oversampler   sOver;              // Oversampler object for signal
                     dspu::Oversampler   sScOver;            // Sidechain oversampler object for signal
-                    dspu::Limiter       sLimit;             // Limiter
+                    ALRLimiter          sLimit;             // Limiter
                     dspu::Delay         sDataDelay;         // Input signal delay
                     dspu::Delay         sDryDelay;          // Dry delay
                     dspu::MeterGraph    sGraph[G_TOTAL];    // Input meter graph
+                    HistoryStore        sHistory[G_TOTAL];  // Multi-resolution history of graphs
+                    size_t              vHistPhase[G_TOTAL];// Number of samples passed to the meter graph since its last dot
                     dspu::Blink         sBlink;             // Gain blink
+                    iir_stage_t         vIIROver[IIR_STAGES_MAX];   // Low-latency oversampler state for signal
+                    iir_stage_t         vIIRScOver[IIR_STAGES_MAX]; // Low-latency oversampler state for sidechain
+                    float               fScPeak;            // Peak of the last group of oversampled sidechain samples
+                    float               fGainLast;          // Last gain computed at base sample rate
+                    float               fTelInPeak;         // Peak input level of the block for telemetry
+                    float               fTelOutPeak;        // Peak output level of the block for telemetry
+                    float               fTelGain;           // Minimum gain of the block for telemetry
+                    bool                bTelAlr;            // Automatic level regulation reduced the gain during the block
+                    wsize_t             vProfile[PS_TOTAL]; // Time spent at processing stages of the channel [ns]
 
                     float              *vIn;                // Input data
                     float              *vSc;                // Sidechain data
@@ -108,11 +212,13 @@ namespace lsp
                     float              *vScBuf;             // Sidechain buffer
                     float              *vGainBuf;           // Applying gain buffer
                     float              *vOutBuf;            // Output buffer
+                    const float        *vLimitSc;           // Sidechain data passed to the limiter
 
                     bool                bVisible[G_TOTAL];  // Input visibility
                     bool                bOutVisible;        // Output visibility
                     bool                bGainVisible;       // Gain visibility
                     bool                bScVisible;         // Sidechain visibility
+                    uint32_t            nLinkGroup;         // Gain linking group
 
                     plug::IPort        *pIn;                // Input port
                     plug::IPort        *pOut;               // Output port
@@ -120,26 +226,69 @@ namespace lsp
                     plug::IPort        *pShmIn;             // Sidechain port
                     plug::IPort        *pVisible[G_TOTAL];  // Input visibility
 
-                    plug::IPort        *pGraph[G_TOTAL];    // History graphs
+                    plug::IPort        *pHistory;           // History stream: input, output, sidechain and gain dots
                     plug::IPort        *pMeter[G_TOTAL];    // Meters
                 } channel_t;
 
             protected:
                 uint32_t            nChannels;      // Number of channels
+                uint32_t            nLinkGroups;    // Number of gain linking groups
                 bool                bSidechain;     // Sidechain presence flag
+                bool                bBypass;        // Bypass is turned on
+                size_t              nBypassFade;    // Number of samples left to the end of bypass transition
                 bool                bPause;         // Pause button
                 bool                bClear;         // Clear button
                 bool                bScListen;      // Sidechain listen
                 channel_t          *vChannels;      // Audio channels
                 float              *vTime;          // Time points buffer
                 float              *vIDisplay;      // Buffer for inline display
+                float              *vHistory;       // Buffer for history dots sent to the UI
+                size_t              nHistPeriod;    // Number of oversampled samples per dot of input, output and gain graphs
+                size_t              nHistScPeriod;  // Number of oversampled sidechain samples per dot of sidechain graph
+                wsize_t             nHistDots;      // Number of history dots produced since the last clear
+                wsize_t             nHistSent;      // Number of history dots of the selected level sent to UI
+                size_t              nHistKey;       // Number of history dots sent since the last full history
+                size_t              nHistLevel;     // Level of the multi-resolution history shown by UI
+                uint32_t            nOversampling;  // Current oversampling factor
+                uint32_t            nScOversampling;// Current oversampling factor of sidechain, may exceed nOversampling
+                uint32_t            nIIRStages;     // Number of stages of low-latency oversampler, 0 if not used
+                bool                bGainDecim;     // Gain is computed at base sample rate and interpolated
+                bool                bLinked;        // Channels of each link group share the gain of one limiter
+                size_t              nLinkWarmup;    // Samples the other limiters of link groups are fed after full linking is released
                 uint32_t            nScMode;        // Sidechain mode
                 float               fInGain;        // Input gain
                 float               fOutGain;       // Output gain
                 float               fPreamp;        // Sidechain pre-amplification
                 float               fStereoLink;    // Stereo linking
+                float               fOldInGain;     // Input gain at the beginning of the block, ramps to fInGain
+                float               fOldOutGain;    // Output gain at the beginning of the block, ramps to fOutGain
+                float               fOldPreamp;     // Sidechain pre-amplification at the beginning of the block, ramps to fPreamp
+                float               fOldStereoLink; // Stereo linking at the beginning of the block, ramps to fStereoLink
+                float               fThresh;        // Limiter threshold
+                float               vParams[P_TOTAL];   // Last applied values of structural parameters
+                bool                bReconfigure;   // Force reconfiguration of all structural parameters
                 core::IDBuffer     *pIDisplay;      // Inline display buffer
                 bool                bUISync;        // Synchronize with UI
+                bool                bReady;         // Delay lines and limiters are allocated for the current sample rate
+                bool                bUIActive;      // UI is currently active
+                bool                bMetering;      // Metering and history are computed
+                bool                bTelemetry;     // Telemetry is collected for the current block
+                wsize_t             nTelPosition;   // Number of samples processed since the start of processing
+                bool                bProfile;       // Profiling of processing stages is on
+                wsize_t             vProfile[PS_TOTAL]; // Time spent at processing stages shared by all channels [ns]
+                wsize_t             nProfSamples;   // Number of samples processed since profiling has been turned on
+                float               fCpuLoad;       // CPU load of the last processed block [%]
+                size_t              nCacheSize;     // Size of the cache that should hold the working set of a block [bytes]
+                size_t              nBlockSize;     // Number of samples processed at once at the original sample rate
+                bool                bCalibrate;     // Calibration of the block size is in progress
+                size_t              nCalibSamples;  // Number of samples processed with the current candidate block size
+                wsize_t             nCalibTime;     // Time spent on processing with the current candidate block size [ns]
+                size_t              nCalibBest;     // The fastest block size found by calibration
+                float               fCalibCost;     // Time per sample of the fastest block size [ns]
+                size_t              nIDisplayIdle;  // Number of samples since last inline display request
+                size_t              nIDisplayDots;  // Number of samples since last inline display redraw request
+                bool                bIDisplayDirty; // Inline display should be redrawn because the state has changed
+                idisplay_t          sIDGeometry;    // Cached geometry of the inline display
 
                 dspu::Dither        sDither;        // Dither
                 premix_t            sPremix;        // Premix
@@ -166,6 +315,12 @@ namespace lsp
                 plug::IPort        *pOversampling;  // Oversampling
                 plug::IPort        *pDithering;     // Dithering
                 plug::IPort        *pStereoLink;    // Stereo linking
+                plug::IPort        *pLfeLink;       // LFE channel linking
+                plug::IPort        *pGainDecim;     // Gain computation at base sample rate
+                plug::IPort        *pHistSpan;      // History span
+                plug::IPort        *pTelemetryOn;   // Telemetry collection
+                plug::IPort        *pTelemetry;     // Telemetry stream
+                plug::IPort        *pCpuLoad;       // CPU load meter
 
                 uint8_t            *pData;          // Allocated data
 
@@ -173,17 +328,36 @@ namespace lsp
                 static bool                 get_filtering(size_t mode);
                 static dspu::limiter_mode_t get_limiter_mode(size_t mode);
                 static size_t               get_dithering(size_t mode);
+                static size_t               get_iir_stages(size_t mode);
+                static bool                 get_sidechain_only(size_t mode);
 
             protected:
                 dspu::over_mode_t           get_oversampling_mode(size_t mode);
                 uint32_t                    decode_sidechain_mode(uint32_t mode);
                 void                        update_premix();
+                uint32_t                    update_params();
                 void                        premix_channel(uint32_t channel, size_t count);
+                void                        link_gains(size_t samples);
+                void                        limit_channel(channel_t *c, size_t to_do);
+                void                        limit_linked(size_t to_do, bool warmup);
+                void                        update_metering(size_t samples);
+                void                        reset_profile();
+                void                        update_block_size();
+                void                        calibrate_block_size(size_t samples, wsize_t time);
+                void                        process_channel_pre(channel_t *c, size_t to_do);
+                void                        process_channel_post(channel_t *c, size_t to_do);
+                void                        upsample(dspu::Oversampler *ovs, iir_stage_t *iir, float *dst, const float *src, size_t count);
+                void                        downsample(dspu::Oversampler *ovs, iir_stage_t *iir, float *dst, const float *src, size_t count);
+                size_t                      oversampler_latency() const;
+                size_t                      limiter_latency() const;
+                size_t                      data_latency() const;
                 void                        sync_latency();
+                bool                        init_delays(long sr);
+                void                        update_idisplay_geometry(core::IDBuffer *b, size_t width, size_t height);
                 void                        do_destroy();
 
             public:
-                explicit limiter(const meta::plugin_t *metadata, bool sc, bool stereo);
+                explicit limiter(const meta::plugin_t *metadata, bool sc, size_t channels);
                 virtual ~limiter() override;
 
             public:
@@ -193,11 +367,50 @@ namespace lsp
                 virtual void        update_settings() override;
                 virtual void        update_sample_rate(long sr) override;
                 virtual void        ui_activated() override;
+                virtual void        ui_deactivated() override;
 
                 virtual void        process(size_t samples) override;
                 virtual bool        inline_display(plug::ICanvas *cv, size_t width, size_t height) override;
 
                 virtual void        dump(dspu::IStateDumper *v) const override;
+
+            public:
+                /**
+                 * Enable profiling of processing stages, the counters are reset when the profiling is turned on.
+                 * Profiling is a development facility, it is not exposed to the host.
+                 * @param enable enable profiling
+                 */
+                void                set_profiling(bool enable);
+
+                /**
+                 * Get the time spent at the processing stage by all channels since profiling has been turned on
+                 * @param stage processing stage
+                 * @return time spent at the processing stage [ns]
+                 */
+                wsize_t             profile(size_t stage) const;
+
+                inline bool         profiling() const           { return bProfile;      }
+                inline wsize_t      profiled_samples() const    { return nProfSamples;  }
+                inline float        cpu_load() const            { return fCpuLoad;      }
+
+                /**
+                 * Start calibration of the internal block size: process() tries block sizes on the actual
+                 * audio stream and keeps the fastest one. The calibration restarts if the oversampling
+                 * changes, should be called when the plugin does not process audio.
+                 */
+                void                calibrate();
+
+                /**
+                 * Check that calibration of the internal block size is in progress
+                 * @return true if calibration is in progress
+                 */
+                inline bool         calibrating() const     { return bCalibrate;    }
+
+                /**
+                 * Get the internal block size
+                 * @return number of samples processed at once at the original sample rate
+                 */
+                inline size_t       block_size() const      { return nBlockSize;    }
         };
     } /* namespace plugins */
 } /* namespace lsp */
@@ -0,0 +1,171 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-limiter
+ * Created on: 17 окт. 2026 г.
+ *
+ * lsp-plugins-limiter is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-limiter is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-limiter. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_TEST_HOST_H_
+#define PRIVATE_TEST_HOST_H_
+
+#include <lsp-plug.in/common/status.h>
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/plug-fw/plug.h>
+
+namespace lsp
+{
+    namespace test
+    {
+        /**
+         * Port that is driven directly by the host without any wrapper
+         */
+        class HostPort: public plug::IPort
+        {
+            private:
+                float           fValue;
+                float          *pBuffer;
+                plug::stream_t *pStream;
+
+            public:
+                explicit HostPort(const meta::port_t *meta);
+                HostPort(const HostPort &) = delete;
+                HostPort(HostPort &&) = delete;
+                virtual ~HostPort() override;
+
+                HostPort & operator = (const HostPort &) = delete;
+                HostPort & operator = (HostPort &&) = delete;
+
+            public:
+                virtual float   value() override;
+                virtual void    set_value(float value) override;
+                virtual void   *buffer() override;
+
+            public:
+                void            bind(float *buf);
+                inline plug::stream_t  *stream()    { return pStream;   }
+        };
+
+        /**
+         * Headless host: instantiates the plugin module without UI, allocates audio buffers
+         * and drives the module directly
+         */
+        class PluginHost
+        {
+            private:
+                const meta::plugin_t   *pMetadata;      // Plugin metadata
+                plug::Module           *pModule;        // Plugin module
+                HostPort              **vPorts;         // List of ports
+                size_t                  nPorts;         // Number of ports
+                float                 **vIn;            // Audio input buffers
+                float                 **vOut;           // Audio output buffers
+                size_t                  nIn;            // Number of audio inputs
+                size_t                  nOut;           // Number of audio outputs
+                size_t                  nBlockSize;     // Maximum number of samples processed at once
+                size_t                  nSampleRate;    // Sample rate
+                wsize_t                 nPosition;      // Number of frames processed by the plugin
+                uint8_t                *pData;          // Allocated data
+
+            protected:
+                static plug::Module    *create_module(const meta::plugin_t *meta);
+
+            public:
+                PluginHost();
+                PluginHost(const PluginHost &) = delete;
+                PluginHost(PluginHost &&) = delete;
+                ~PluginHost();
+
+                PluginHost & operator = (const PluginHost &) = delete;
+                PluginHost & operator = (PluginHost &&) = delete;
+
+                /**
+                 * Instantiate the plugin
+                 * @param meta plugin metadata
+                 * @param sample_rate sample rate
+                 * @param block_size maximum number of samples passed to process()
+                 * @return status of operation
+                 */
+                status_t                init(const meta::plugin_t *meta, size_t sample_rate, size_t block_size);
+
+                /**
+                 * Destroy the plugin and free all allocated resources
+                 */
+                void                    destroy();
+
+            public:
+                inline const meta::plugin_t *metadata() const   { return pMetadata;     }
+                inline plug::Module    *module()                { return pModule;       }
+                inline size_t           inputs() const          { return nIn;           }
+                inline size_t           outputs() const         { return nOut;          }
+                inline size_t           block_size() const      { return nBlockSize;    }
+                inline size_t           sample_rate() const     { return nSampleRate;   }
+                inline wsize_t          position() const        { return nPosition;     }
+                inline float           *input(size_t index)     { return (index < nIn) ? vIn[index] : NULL;     }
+                inline float           *output(size_t index)    { return (index < nOut) ? vOut[index] : NULL;   }
+
+                /**
+                 * Find port by identifier
+                 * @param id port identifier
+                 * @return port or NULL if not found
+                 */
+                HostPort               *port(const char *id);
+
+                /**
+                 * Set value of the port
+                 * @param id port identifier
+                 * @param value value to set
+                 * @return status of operation
+                 */
+                status_t                set_value(const char *id, float value);
+
+                /**
+                 * Set value of the port from the string in form 'id=value'. The value may be a number,
+                 * 'true', 'false' or a number with 'db' suffix for gain ports.
+                 * @param param parameter string
+                 * @return status of operation
+                 */
+                status_t                set_param(const char *param);
+
+                /**
+                 * Load port values from the preset file. Each line of the file has 'id = value' form,
+                 * lines starting with '#' are comments. Ports not known to the plugin are ignored.
+                 * @param path path to the preset file
+                 * @return status of operation
+                 */
+                status_t                load_preset(const char *path);
+
+                /**
+                 * Apply current port values to the module
+                 */
+                void                    update_settings();
+
+                /**
+                 * Process audio data stored in input buffers and store result into output buffers
+                 * @param samples number of samples to process, limited by the block size
+                 */
+                void                    process(size_t samples);
+
+                /**
+                 * Get the latency reported by the plugin
+                 * @return latency in samples
+                 */
+                size_t                  latency() const;
+        };
+
+    } /* namespace test */
+} /* namespace lsp */
+
+#endif /* PRIVATE_TEST_HOST_H_ */
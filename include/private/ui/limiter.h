@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-limiter
+ * Created on: 17 окт. 2026 г.
+ *
+ * lsp-plugins-limiter is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-limiter is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-limiter. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_UI_LIMITER_H_
+#define PRIVATE_UI_LIMITER_H_
+
+#include <lsp-plug.in/plug-fw/ui.h>
+
+#include <private/meta/limiter.h>
+
+namespace lsp
+{
+    namespace plugui
+    {
+        /**
+         * UI for Limiter plugin series: keeps its own copy of the history and updates it
+         * with new dots received from the history stream of each channel
+         */
+        class limiter_ui: public ui::Module, public ui::IPortListener
+        {
+            protected:
+                enum graph_t
+                {
+                    G_IN,
+                    G_OUT,
+                    G_SC,
+                    G_GAIN,
+
+                    G_TOTAL
+                };
+
+                typedef struct channel_t
+                {
+                    ui::IPort          *pStream;            // History stream port
+                    uint32_t            nFrameId;           // Identifier of the last consumed frame
+                    float              *vHistory[G_TOTAL];  // History of each graph
+                    tk::GraphMesh      *wGraph[G_TOTAL];    // Mesh of each graph
+                } channel_t;
+
+            protected:
+                channel_t           vChannels[meta::limiter_metadata::CHANNELS_MAX];
+                size_t              nChannels;          // Number of channels
+                float              *vTime;              // Time points of history dots
+                float              *vX;                 // Buffer for mesh horizontal coordinates
+                float              *vY;                 // Buffer for mesh vertical coordinates
+                uint8_t            *pData;              // Allocated data
+
+            protected:
+                bool                consume_frames(channel_t *c);
+                void                sync_mesh(channel_t *c, size_t graph);
+
+            public:
+                explicit limiter_ui(const meta::plugin_t *meta);
+                limiter_ui(const limiter_ui &) = delete;
+                limiter_ui(limiter_ui &&) = delete;
+                virtual ~limiter_ui() override;
+
+                limiter_ui & operator = (const limiter_ui &) = delete;
+                limiter_ui & operator = (limiter_ui &&) = delete;
+
+                virtual status_t    post_init() override;
+                virtual void        destroy() override;
+
+            public:
+                virtual void        notify(ui::IPort *port, size_t flags) override;
+        };
+
+    } /* namespace plugui */
+} /* namespace lsp */
+
+#endif /* PRIVATE_UI_LIMITER_H_ */
@@ -4,6 +4,7 @@
 	$sc     =   (strpos($PAGE, 'sc_') === 0);
 	$m      =   (strpos($PAGE, '_mono') > 0) ? 'm' : 's';
 	$cc     =   ($m == 'm') ? 'mono' : 'stereo';
+	$mc     =   preg_match('/_\d+_\d+(_\d+)?$/', $PAGE);
 ?>
 
 <p>
@@ -64,10 +65,14 @@ words: the more work should be done, the more CPU resources will be used. Beware
 	<li>
 		<b>Bypass</b> - bypass switch, when turned on (led indicator is shining), the plugin bypasses signal.
 	</li>
+	<?php if (!$mc) {?> 
 	<li><b>Pre-mix</b> - shows pre-mix control overlay.</li>
+	<?php } ?>
 	<li><b>ALR</b> - enables automatic level regulation.</li>
 	<li><b>Pause</b> - pauses any updates of the limiter graph.</li>
 	<li><b>Clear</b> - clears all graphs.</li>
+	<li><b>History span</b> - time span of the limiter graph. Long spans show the peaks of the signal and the deepest
+	gain reduction over each displayed dot. History is collected only while the UI or the inline display is shown.</li>
 	<li><b>Mode</b> - the selected mode to use by limiter:</li>
 	<ul>
 		<li><b>Herm Thin</b>, <b>Herm Wide</b>, <b>Herm Tail</b>, <b>Herm Duck</b> - hermite-interpolated cubic functions are used to apply gain reduction.</b>
@@ -99,9 +104,23 @@ words: the more work should be done, the more CPU resources will be used. Beware
 		<li><b>Full 8x/24 bit</b> - 8x Lanczos oversampling of Sidechain signal and Input signal with 24-bit precision of output samples.</li>
 		<li><b>True Peak/16 bit</b> - Sample-rate dependent Lanczos oversampling of Sidechain signal 16-bit precision of output samples for elimination of true peaks.</li>
 		<li><b>True Peak/32 bit</b> - Sample-rate dependent Lanczos oversampling of Sidechain signal 24-bit precision of output samples for elimination of true peaks.</li>
+		<li><b>IIR x2 (PDC LF)</b> - 2x oversampling of Sidechain signal and Input signal with polyphase IIR filters. The reported latency is 3 samples which is the delay of low frequencies only, high frequencies are delayed more: about 4 samples at 0.2&middot;fs, 5.5 samples at 0.3&middot;fs and 9.7 samples at 0.4&middot;fs.</li>
+		<li><b>IIR x4 (PDC LF)</b> - 4x oversampling of Sidechain signal and Input signal with polyphase IIR filters. The reported latency is 4 samples which is the delay of low frequencies only, high frequencies are delayed more: about 4.9 samples at 0.2&middot;fs, 6.4 samples at 0.3&middot;fs and 10.7 samples at 0.4&middot;fs.</li>
+		<li><b>IIR x8 (PDC LF)</b> - 8x oversampling of Sidechain signal and Input signal with polyphase IIR filters. The reported latency is 4 samples which is the delay of low frequencies only, high frequencies are delayed more: about 5.2 samples at 0.2&middot;fs, 6.7 samples at 0.3&middot;fs and 11 samples at 0.4&middot;fs.</li>
+		<li><b>Note:</b> IIR modes are not linear-phase, the host delay compensation (PDC) is exact only for low frequencies.
+		Gain reduction is still applied sample-accurately since the Input and Sidechain signals pass the same filters, but
+		mixing the output with a parallel dry signal may cause comb filtering at high frequencies.</li>
+		<li><b>Sidechain x2</b> - 2x Lanczos oversampling of Sidechain signal only, inter-sample peaks are detected on the oversampled Sidechain signal and the gain reduction is applied to the Input signal at the original sample rate.</li>
+		<li><b>Sidechain x4</b> - 4x Lanczos oversampling of Sidechain signal only, inter-sample peaks are detected on the oversampled Sidechain signal and the gain reduction is applied to the Input signal at the original sample rate.</li>
+		<li><b>Sidechain x8</b> - 8x Lanczos oversampling of Sidechain signal only, inter-sample peaks are detected on the oversampled Sidechain signal and the gain reduction is applied to the Input signal at the original sample rate.</li>
 	</ul>
 	<li><b>Dither</b> - allows to enable dithering for the specified sample bitness.</li>
+	<li><b>Fast gain</b> - computes the gain reduction at the original sample rate when oversampling is enabled. The peaks are
+	still detected on the oversampled sidechain signal, the gain curve is interpolated back to the oversampled signal. This
+	significantly reduces CPU usage at high oversampling factors and adds one sample of latency.</li>
+	<?php if (!$mc) {?> 
 	<li><b>Link</b> - the name of the shared memory link to pass sidechain signal.</li>
+	<?php } ?>
 	<li><b>SC</b> - enables drawing of sidechain input graph and corresponding level meter.</li>
 	<li><b>Gain</b> - enables drawing of gain amplification line and corresponding amplification meter.</li>
 	<li><b>In</b> - enables drawing of limiter's input signal graph and corresponding level meter.</li>
@@ -136,14 +155,19 @@ words: the more work should be done, the more CPU resources will be used. Beware
 	<?php if ($sc) {?> 
 		<li><b>External</b> - the signal at additional sidechain audio inputs is used as sidechain signal.</li>
 	<?php }?>
+	<?php if (!$mc) {?> 
 		<li><b>Link</b> - sidechain input is passed by shared memory link.</li>
+	<?php }?>
 	</ul>
 	<li><b>Lookahead</b> - the size of lookahead buffer in milliseconds. Forces the limiter to add the corresponding latency to output signal.</li>
 	<li><b>Threshold</b> - the maximum input level of the signal allowed by limiter.</li>
 	<li><b>Boost</b> - applies corresponding to the <b>Threshold</b> gain to the output signal.</li>
 	<li><b>Attack</b> - the attack time of the limiter. Can not be greater than Lookahead time (greater values are truncated) for some modes.</li>
 	<li><b>Release</b> - the attack time of the limiter. Can not be twice greater than Lookahead time (greater values are truncated) for some modes.</li>
-	<?php if (!$m) {?> 
+	<?php if ($mc) {?> 
+	<li><b>Channel link</b> - channel link, the degree of mutual influence between gain reduction of all channels</li>
+	<li><b>LFE link</b> - includes the LFE channel into the channel linking, otherwise the LFE channel is processed independently</li>
+	<?php } else if (!$m) {?> 
 	<li><b>Stereo link</b> - stereo link, the degree of mutual influence between gain reduction of stereo channels</li>
 	<?php } ?>
 </ul>
@@ -153,6 +177,7 @@ words: the more work should be done, the more CPU resources will be used. Beware
 	<li><b>Output</b> - overall output signal gain adjustment.</li>
 </ul>
 
+<?php if (!$mc) {?> 
 <p><b>Pre-mix control overlay:</b></p>
 <ul>
 	<?php if ($sc) { ?>
@@ -166,4 +191,5 @@ words: the more work should be done, the more CPU resources will be used. Beware
 	<li><b>Link -> In</b> - the amount of signal from shared memory link added to the input channel.</li>
 	<li><b>Link -> SC</b> - the amount of signal from shared memory link added to the sidechain channel.</li>
 </ul>
+<?php } ?>
 
@@ -43,11 +43,24 @@ namespace lsp
         #define REV_0       0
         #define REV_1       1
 
+        // LADSPA identifiers of surround variants are allocated in the shared list of LADSPA identifiers,
+        // the variants are not exported to LADSPA while the shared list does not provide them
+        #ifdef LSP_LADSPA_LIMITER_SURROUND_BASE
+            #define LIMIT_LADSPA_SURROUND(index, id) \
+                LSP_LADSPA_LIMITER_SURROUND_BASE + index, \
+                LSP_LADSPA_URI(id)
+        #else
+            #define LIMIT_LADSPA_SURROUND(index, id) \
+                0, \
+                NULL
+        #endif /* LSP_LADSPA_LIMITER_SURROUND_BASE */
+
         //-------------------------------------------------------------------------
         // Limiter
         static const int plugin_classes[]           = { C_LIMITER, -1 };
         static const int clap_features_mono[]       = { CF_AUDIO_EFFECT, CF_LIMITER, CF_MONO, -1 };
         static const int clap_features_stereo[]     = { CF_AUDIO_EFFECT, CF_LIMITER, CF_STEREO, -1 };
+        static const int clap_features_surround[]   = { CF_AUDIO_EFFECT, CF_LIMITER, CF_SURROUND, -1 };
 
         static port_item_t limiter_oper_modes[] =
         {
@@ -98,6 +111,14 @@ namespace lsp
             { "True Peak/16 bit", "oversampler.true_peak.16bit"  },
             { "True Peak/24 bit", "oversampler.true_peak.24bit"  },
 
+            { "IIR x2 (PDC LF)", "limiter.ovs_ll_2x"       },
+            { "IIR x4 (PDC LF)", "limiter.ovs_ll_4x"       },
+            { "IIR x8 (PDC LF)", "limiter.ovs_ll_8x"       },
+
+            { "Sidechain x2",   "limiter.ovs_sc_2x"         },
+            { "Sidechain x4",   "limiter.ovs_sc_4x"         },
+            { "Sidechain x8",   "limiter.ovs_sc_8x"         },
+
             { NULL, NULL }
         };
 
@@ -115,6 +136,15 @@ namespace lsp
             { NULL, NULL }
         };
 
+        static const port_item_t limiter_history_spans[] =
+        {
+            { "4 s",            "limiter.hspan_4s"      },
+            { "32 s",           "limiter.hspan_32s"     },
+            { "64 s",           "limiter.hspan_64s"     },
+            { "256 s",          "limiter.hspan_256s"    },
+            { NULL, NULL }
+        };
+
         static const port_item_t limiter_sc_type[] =
         {
             { "Internal",       "sidechain.internal"    },
@@ -163,6 +193,15 @@ namespace lsp
             SWITCH("pause", "Pause graph analysis", "Pause", 0.0f), \
             TRIGGER("clear", "Clear graph analysis", "Clear")
 
+        // Ports added after the first release are placed at the end of the port list
+        // to keep indices of existing ports unchanged
+        #define LIMIT_EXTRA \
+            SWITCH("gdec", "Gain computation at base sample rate", "Fast gain", 0.0f), \
+            COMBO("hspan", "History time span", "History span", limiter_metadata::HSPAN_DEFAULT, limiter_history_spans), \
+            SWITCH("tlm", "Telemetry collection", "Telemetry", 0.0f), \
+            STREAM("tlms", "Telemetry stream", limiter_metadata::TLM_BUFFERS, limiter_metadata::TELEMETRY_FRAMES, limiter_metadata::TELEMETRY_SIZE), \
+            METER("cpu", "CPU load", U_PERCENT, limiter_metadata::CPU_LOAD)
+
         #define LIMIT_SHM_LINK_MONO \
             OPT_RETURN_MONO("link", "shml", "Side-chain shared memory link")
 
@@ -187,6 +226,11 @@ namespace lsp
             COMBO("extsc", "Sidechain type", "SC type", 0.0f, limiter_sc_type_for_sc), \
             LOG_CONTROL("slink", "Stereo linking", "Stereo link", U_PERCENT, limiter_metadata::LINKING)
 
+        #define LIMIT_COMMON_MC         \
+            LIMIT_COMMON, \
+            LOG_CONTROL("slink", "Channel linking", "Chan link", U_PERCENT, limiter_metadata::LINKING), \
+            SWITCH("lfelk", "LFE channel linking", "LFE link", 0.0f)
+
         #define LIMIT_METERS(id, label, alias) \
             SWITCH("igv" id, "Input graph visibility" label, "Show In" alias, 1.0f), \
             SWITCH("ogv" id, "Output graph visibility" label, "Show Out" alias, 1.0f), \
@@ -195,14 +239,50 @@ namespace lsp
             METER_OUT_GAIN("ilm" id, "Input level meter" label, GAIN_AMP_0_DB), \
             METER_OUT_GAIN("olm" id, "Output level meter" label, GAIN_AMP_0_DB), \
             METER_OUT_GAIN("sclm" id, "Sidechain level meter" label, GAIN_AMP_0_DB), \
-            METER_GAIN_DFL("grlm" id, "Gain reduction level meter" label, GAIN_AMP_0_DB, GAIN_AMP_0_DB), \
+            METER_GAIN_DFL("grlm" id, "Gain reduction level meter" label, GAIN_AMP_0_DB, GAIN_AMP_0_DB)
+
+        // Graph meshes are not filled anymore, they are kept to preserve indices of ports of the first release
+        #define LIMIT_GRAPHS(id, label, alias) \
+            LIMIT_METERS(id, label, alias), \
             MESH("ig" id, "Input graph" label, 2, limiter_metadata::HISTORY_MESH_SIZE + 2), \
             MESH("og" id, "Output graph" label, 2, limiter_metadata::HISTORY_MESH_SIZE), \
             MESH("scg" id, "Sidechain graph" label, 2, limiter_metadata::HISTORY_MESH_SIZE), \
             MESH("grg" id, "Gain graph" label, 2, limiter_metadata::HISTORY_MESH_SIZE + 4)
 
-        #define LIMIT_METERS_MONO       LIMIT_METERS("", "", "")
-        #define LIMIT_METERS_STEREO     LIMIT_METERS("_l", " Left", " L"), LIMIT_METERS("_r", " Right", " R")
+        #define LIMIT_METERS_MONO       LIMIT_GRAPHS("", "", "")
+        #define LIMIT_METERS_STEREO     LIMIT_GRAPHS("_l", " Left", " L"), LIMIT_GRAPHS("_r", " Right", " R")
+
+        #define LIMIT_HISTORY(id, label, alias) \
+            STREAM("hs" id, "History stream" label, 4, limiter_metadata::HISTORY_STREAM_FRAMES, limiter_metadata::HISTORY_STREAM_SIZE)
+
+        #define LIMIT_HISTORY_MONO      LIMIT_HISTORY("", "", "")
+        #define LIMIT_HISTORY_STEREO    LIMIT_HISTORY("_l", " Left", " L"), LIMIT_HISTORY("_r", " Right", " R")
+
+        #define LIMIT_AUDIO_IN(id, label, alias) \
+            AUDIO_INPUT("in" id, "Input" label, "In" alias)
+
+        #define LIMIT_AUDIO_OUT(id, label, alias) \
+            AUDIO_OUTPUT("out" id, "Output" label, "Out" alias)
+
+        #define LIMIT_CHANNELS_5_1(X) \
+            X("_l", " Left", " L"), \
+            X("_r", " Right", " R"), \
+            X("_c", " Center", " C"), \
+            X("_lfe", " LFE", " LFE"), \
+            X("_ls", " Left Surround", " Ls"), \
+            X("_rs", " Right Surround", " Rs")
+
+        #define LIMIT_CHANNELS_7_1(X) \
+            LIMIT_CHANNELS_5_1(X), \
+            X("_lb", " Left Back", " Lb"), \
+            X("_rb", " Right Back", " Rb")
+
+        #define LIMIT_CHANNELS_7_1_4(X) \
+            LIMIT_CHANNELS_7_1(X), \
+            X("_ltf", " Left Top Front", " Ltf"), \
+            X("_rtf", " Right Top Front", " Rtf"), \
+            X("_ltb", " Left Top Back", " Ltb"), \
+            X("_rtb", " Right Top Back", " Rtb")
 
         static const port_t limiter_mono_ports[] =
         {
@@ -211,6 +291,8 @@ namespace lsp
             LIMIT_PREMIX,
             LIMIT_COMMON_MONO,
             LIMIT_METERS_MONO,
+            LIMIT_EXTRA,
+            LIMIT_HISTORY_MONO,
 
             PORTS_END
         };
@@ -222,6 +304,8 @@ namespace lsp
             LIMIT_PREMIX,
             LIMIT_COMMON_STEREO,
             LIMIT_METERS_STEREO,
+            LIMIT_EXTRA,
+            LIMIT_HISTORY_STEREO,
 
             PORTS_END
         };
@@ -234,6 +318,8 @@ namespace lsp
             LIMIT_SC_PREMIX,
             LIMIT_COMMON_SC_MONO,
             LIMIT_METERS_MONO,
+            LIMIT_EXTRA,
+            LIMIT_HISTORY_MONO,
 
             PORTS_END
         };
@@ -246,10 +332,132 @@ namespace lsp
             LIMIT_SC_PREMIX,
             LIMIT_COMMON_SC_STEREO,
             LIMIT_METERS_STEREO,
+            LIMIT_EXTRA,
+            LIMIT_HISTORY_STEREO,
 
             PORTS_END
         };
 
+        static const port_t limiter_5_1_ports[] =
+        {
+            LIMIT_CHANNELS_5_1(LIMIT_AUDIO_IN),
+            LIMIT_CHANNELS_5_1(LIMIT_AUDIO_OUT),
+            LIMIT_COMMON_MC,
+            LIMIT_CHANNELS_5_1(LIMIT_METERS),
+            LIMIT_EXTRA,
+            LIMIT_CHANNELS_5_1(LIMIT_HISTORY),
+
+            PORTS_END
+        };
+
+        static const port_t limiter_7_1_ports[] =
+        {
+            LIMIT_CHANNELS_7_1(LIMIT_AUDIO_IN),
+            LIMIT_CHANNELS_7_1(LIMIT_AUDIO_OUT),
+            LIMIT_COMMON_MC,
+            LIMIT_CHANNELS_7_1(LIMIT_METERS),
+            LIMIT_EXTRA,
+            LIMIT_CHANNELS_7_1(LIMIT_HISTORY),
+
+            PORTS_END
+        };
+
+        static const port_t limiter_7_1_4_ports[] =
+        {
+            LIMIT_CHANNELS_7_1_4(LIMIT_AUDIO_IN),
+            LIMIT_CHANNELS_7_1_4(LIMIT_AUDIO_OUT),
+            LIMIT_COMMON_MC,
+            LIMIT_CHANNELS_7_1_4(LIMIT_METERS),
+            LIMIT_EXTRA,
+            LIMIT_CHANNELS_7_1_4(LIMIT_HISTORY),
+
+            PORTS_END
+        };
+
+        #define LIMIT_GROUP_5_1(id) \
+            { id "_l",      PGR_LEFT        }, \
+            { id "_r",      PGR_RIGHT       }, \
+            { id "_c",      PGR_CENTER      }, \
+            { id "_lfe",    PGR_LO_FREQ     }, \
+            { id "_ls",     PGR_REAR_LEFT   }, \
+            { id "_rs",     PGR_REAR_RIGHT  }
+
+        #define LIMIT_GROUP_7_1(id) \
+            { id "_l",      PGR_LEFT        }, \
+            { id "_r",      PGR_RIGHT       }, \
+            { id "_c",      PGR_CENTER      }, \
+            { id "_lfe",    PGR_LO_FREQ     }, \
+            { id "_ls",     PGR_SIDE_LEFT   }, \
+            { id "_rs",     PGR_SIDE_RIGHT  }, \
+            { id "_lb",     PGR_REAR_LEFT   }, \
+            { id "_rb",     PGR_REAR_RIGHT  }
+
+        // Height channels of 7.1.4 layout have no dedicated roles, they form a separate quadraphonic group
+        #define LIMIT_GROUP_TOP(id) \
+            { id "_ltf",    PGR_LEFT        }, \
+            { id "_rtf",    PGR_RIGHT       }, \
+            { id "_ltb",    PGR_REAR_LEFT   }, \
+            { id "_rtb",    PGR_REAR_RIGHT  }
+
+        static const port_group_item_t limiter_5_1_in_group_ports[] =
+        {
+            LIMIT_GROUP_5_1("in"),
+            { NULL }
+        };
+
+        static const port_group_item_t limiter_5_1_out_group_ports[] =
+        {
+            LIMIT_GROUP_5_1("out"),
+            { NULL }
+        };
+
+        static const port_group_item_t limiter_7_1_in_group_ports[] =
+        {
+            LIMIT_GROUP_7_1("in"),
+            { NULL }
+        };
+
+        static const port_group_item_t limiter_7_1_out_group_ports[] =
+        {
+            LIMIT_GROUP_7_1("out"),
+            { NULL }
+        };
+
+        static const port_group_item_t limiter_top_in_group_ports[] =
+        {
+            LIMIT_GROUP_TOP("in"),
+            { NULL }
+        };
+
+        static const port_group_item_t limiter_top_out_group_ports[] =
+        {
+            LIMIT_GROUP_TOP("out"),
+            { NULL }
+        };
+
+        static const port_group_t limiter_5_1_port_groups[] =
+        {
+            { "5_1_in",     "5.1 Input",        GRP_5_1,    PGF_IN | PGF_MAIN,      limiter_5_1_in_group_ports      },
+            { "5_1_out",    "5.1 Output",       GRP_5_1,    PGF_OUT | PGF_MAIN,     limiter_5_1_out_group_ports     },
+            PORT_GROUPS_END
+        };
+
+        static const port_group_t limiter_7_1_port_groups[] =
+        {
+            { "7_1_in",     "7.1 Input",        GRP_7_1,    PGF_IN | PGF_MAIN,      limiter_7_1_in_group_ports      },
+            { "7_1_out",    "7.1 Output",       GRP_7_1,    PGF_OUT | PGF_MAIN,     limiter_7_1_out_group_ports     },
+            PORT_GROUPS_END
+        };
+
+        static const port_group_t limiter_7_1_4_port_groups[] =
+        {
+            { "7_1_in",     "7.1 Input",        GRP_7_1,    PGF_IN | PGF_MAIN,      limiter_7_1_in_group_ports      },
+            { "7_1_out",    "7.1 Output",       GRP_7_1,    PGF_OUT | PGF_MAIN,     limiter_7_1_out_group_ports     },
+            { "top_in",     "Top Input",        GRP_4_0,    PGF_IN,                 limiter_top_in_group_ports      },
+            { "top_out",    "Top Output",       GRP_4_0,    PGF_OUT,                limiter_top_out_group_ports     },
+            PORT_GROUPS_END
+        };
+
         const meta::bundle_t limiter_bundle =
         {
             "limiter",
@@ -388,5 +596,98 @@ namespace lsp
         };
         LSP_REGISTER_METADATA(sc_limiter_stereo);
 
+        const meta::plugin_t  limiter_5_1 =
+        {
+            "Begrenzer 5.1",
+            "Limiter 5.1",
+            "Limiter 5.1",
+            "B1X6",
+            &developers::v_sadovnikov,
+            "limiter_5_1",
+            {
+                LSP_LV2_URI("limiter_5_1"),
+                LSP_LV2UI_URI("limiter_5_1"),
+                "lx6a",
+                LSP_VST3_UID("b1x6    lx6a"),
+                LSP_VST3UI_UID("b1x6    lx6a"),
+                LIMIT_LADSPA_SURROUND(0, "limiter_5_1"),
+                LSP_CLAP_URI("limiter_5_1"),
+                LSP_GST_UID("limiter_5_1"),
+            },
+            LSP_PLUGINS_LIMITER_VERSION,
+            plugin_classes,
+            clap_features_surround,
+            E_INLINE_DISPLAY | E_DUMP_STATE,
+            limiter_5_1_ports,
+            "plugins/dynamics/limiter/single/surround.xml",
+            NULL,
+            limiter_5_1_port_groups,
+            &limiter_bundle,
+            5
+        };
+        LSP_REGISTER_METADATA(limiter_5_1);
+
+        const meta::plugin_t  limiter_7_1 =
+        {
+            "Begrenzer 7.1",
+            "Limiter 7.1",
+            "Limiter 7.1",
+            "B1X8",
+            &developers::v_sadovnikov,
+            "limiter_7_1",
+            {
+                LSP_LV2_URI("limiter_7_1"),
+                LSP_LV2UI_URI("limiter_7_1"),
+                "lx8b",
+                LSP_VST3_UID("b1x8    lx8b"),
+                LSP_VST3UI_UID("b1x8    lx8b"),
+                LIMIT_LADSPA_SURROUND(1, "limiter_7_1"),
+                LSP_CLAP_URI("limiter_7_1"),
+                LSP_GST_UID("limiter_7_1"),
+            },
+            LSP_PLUGINS_LIMITER_VERSION,
+            plugin_classes,
+            clap_features_surround,
+            E_INLINE_DISPLAY | E_DUMP_STATE,
+            limiter_7_1_ports,
+            "plugins/dynamics/limiter/single/surround.xml",
+            NULL,
+            limiter_7_1_port_groups,
+            &limiter_bundle,
+            6
+        };
+        LSP_REGISTER_METADATA(limiter_7_1);
+
+        const meta::plugin_t  limiter_7_1_4 =
+        {
+            "Begrenzer 7.1.4",
+            "Limiter 7.1.4",
+            "Limiter 7.1.4",
+            "B1X12",
+            &developers::v_sadovnikov,
+            "limiter_7_1_4",
+            {
+                LSP_LV2_URI("limiter_7_1_4"),
+                LSP_LV2UI_URI("limiter_7_1_4"),
+                "lxcd",
+                LSP_VST3_UID("b1x12   lxcd"),
+                LSP_VST3UI_UID("b1x12   lxcd"),
+                LIMIT_LADSPA_SURROUND(2, "limiter_7_1_4"),
+                LSP_CLAP_URI("limiter_7_1_4"),
+                LSP_GST_UID("limiter_7_1_4"),
+            },
+            LSP_PLUGINS_LIMITER_VERSION,
+            plugin_classes,
+            clap_features_surround,
+            E_INLINE_DISPLAY | E_DUMP_STATE,
+            limiter_7_1_4_ports,
+            "plugins/dynamics/limiter/single/surround.xml",
+            NULL,
+            limiter_7_1_4_port_groups,
+            &limiter_bundle,
+            7
+        };
+        LSP_REGISTER_METADATA(limiter_7_1_4);
+
     } /* namespace meta */
 } /* namespace lsp */
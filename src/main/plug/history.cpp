@@ -0,0 +1,200 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-limiter
+ * Created on: 17 окт. 2026 г.
+ *
+ * lsp-plugins-limiter is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-limiter is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-limiter. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <private/plugins/history.h>
+#include <lsp-plug.in/common/alloc.h>
+#include <lsp-plug.in/dsp/dsp.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        HistoryStore::HistoryStore()
+        {
+            vLevels         = NULL;
+            nLevels         = 0;
+            nCapacity       = 0;
+            nDots           = 0;
+            fDefault        = 0.0f;
+            pData           = NULL;
+        }
+
+        HistoryStore::~HistoryStore()
+        {
+            destroy();
+        }
+
+        bool HistoryStore::init(size_t levels, size_t capacity, float dfl)
+        {
+            destroy();
+            if ((levels <= 0) || (capacity <= 0))
+                return false;
+
+            const size_t l_size     = align_size(sizeof(level_t) * levels, DEFAULT_ALIGN);
+            const size_t d_size     = align_size(sizeof(float) * capacity, DEFAULT_ALIGN);
+            const size_t allocate   = l_size + d_size * levels * 2;
+
+            uint8_t *ptr            = alloc_aligned<uint8_t>(pData, allocate, DEFAULT_ALIGN);
+            if (ptr == NULL)
+                return false;
+
+            vLevels                 = advance_ptr_bytes<level_t>(ptr, l_size);
+            for (size_t i=0; i<levels; ++i)
+            {
+                level_t *l              = &vLevels[i];
+                l->vMin                 = advance_ptr_bytes<float>(ptr, d_size);
+                l->vMax                 = advance_ptr_bytes<float>(ptr, d_size);
+            }
+
+            nLevels                 = levels;
+            nCapacity               = capacity;
+            fDefault                = dfl;
+
+            clear();
+
+            return true;
+        }
+
+        void HistoryStore::destroy()
+        {
+            if (pData != NULL)
+            {
+                free_aligned(pData);
+                pData           = NULL;
+            }
+            vLevels         = NULL;
+            nLevels         = 0;
+            nCapacity       = 0;
+            nDots           = 0;
+        }
+
+        void HistoryStore::clear()
+        {
+            for (size_t i=0; i<nLevels; ++i)
+            {
+                level_t *l      = &vLevels[i];
+                dsp::fill(l->vMin, fDefault, nCapacity);
+                dsp::fill(l->vMax, fDefault, nCapacity);
+                l->fMin         = fDefault;
+                l->fMax         = fDefault;
+                l->bPending     = false;
+            }
+
+            nDots           = 0;
+        }
+
+        void HistoryStore::push(const float *src, size_t count)
+        {
+            if (nLevels <= 0)
+                return;
+
+            for (size_t i=0; i<count; ++i)
+            {
+                // The write position of the level N moves once per 2^N dots
+                float vmin      = src[i];
+                float vmax      = src[i];
+                wsize_t index   = nDots++;
+
+                for (size_t j=0; j<nLevels; ++j, index >>= 1)
+                {
+                    level_t *l      = &vLevels[j];
+                    const size_t k  = index % nCapacity;
+                    l->vMin[k]      = vmin;
+                    l->vMax[k]      = vmax;
+
+                    // Wait for the second half of the upper level dot
+                    if (!l->bPending)
+                    {
+                        l->fMin         = vmin;
+                        l->fMax         = vmax;
+                        l->bPending     = true;
+                        break;
+                    }
+
+                    vmin            = lsp_min(vmin, l->fMin);
+                    vmax            = lsp_max(vmax, l->fMax);
+                    l->bPending     = false;
+                }
+            }
+        }
+
+        void HistoryStore::read(float *dst, size_t count, size_t level, bool minimum) const
+        {
+            if ((level >= nLevels) || (count <= 0))
+            {
+                dsp::fill(dst, fDefault, count);
+                return;
+            }
+
+            // Complete dots are read, the pending dot of the level is not shown yet
+            const level_t *l    = &vLevels[level];
+            const float *src    = (minimum) ? l->vMin : l->vMax;
+            const size_t dots   = lsp_min(count, nCapacity);
+            const size_t head   = (nDots >> level) % nCapacity;
+            const size_t tail   = (head + nCapacity - dots) % nCapacity;
+
+            // Pad the oldest dots which are out of capacity
+            if (count > dots)
+            {
+                dsp::fill(dst, fDefault, count - dots);
+                dst        += count - dots;
+            }
+
+            if (tail + dots <= nCapacity)
+                dsp::copy(dst, &src[tail], dots);
+            else
+            {
+                const size_t part   = nCapacity - tail;
+                dsp::copy(dst, &src[tail], part);
+                dsp::copy(&dst[part], src, dots - part);
+            }
+        }
+
+        void HistoryStore::dump(dspu::IStateDumper *v) const
+        {
+            v->begin_array("vLevels", vLevels, nLevels);
+            {
+                for (size_t i=0; i<nLevels; ++i)
+                {
+                    const level_t *l = &vLevels[i];
+
+                    v->begin_object(l, sizeof(level_t));
+                    {
+                        v->write("vMin", l->vMin);
+                        v->write("vMax", l->vMax);
+                        v->write("fMin", l->fMin);
+                        v->write("fMax", l->fMax);
+                        v->write("bPending", l->bPending);
+                    }
+                    v->end_object();
+                }
+            }
+            v->end_array();
+
+            v->write("nLevels", nLevels);
+            v->write("nCapacity", nCapacity);
+            v->write("nDots", nDots);
+            v->write("fDefault", fDefault);
+            v->write("pData", pData);
+        }
+
+    } /* namespace plugins */
+} /* namespace lsp */
@@ -25,16 +25,27 @@
 #include <lsp-plug.in/dsp/dsp.h>
 #include <lsp-plug.in/dsp-units/units.h>
 #include <lsp-plug.in/plug-fw/core/AudioBuffer.h>
+#include <lsp-plug.in/runtime/system.h>
 #include <lsp-plug.in/stdlib/math.h>
 #include <lsp-plug.in/shared/debug.h>
 #include <lsp-plug.in/shared/id_colors.h>
 
+#ifdef PLATFORM_POSIX
+    #include <unistd.h>
+#endif /* PLATFORM_POSIX */
+
 namespace lsp
 {
     namespace plugins
     {
-        static constexpr size_t LIMIT_BUFSIZE       = 8192;
+        static constexpr size_t LIMIT_BUFSIZE       = 8192;     // Size of buffers at the highest sample rate
         static constexpr size_t LIMIT_BUFMULTIPLE   = 16;
+        static constexpr size_t LIMIT_BLOCK_MIN     = 64;       // Minimum block size at the original sample rate
+        static constexpr size_t LIMIT_CACHE_SIZE    = 0x40000;  // Cache size if it can not be detected, 256 KB
+        static constexpr float  CALIBRATION_TIME    = 0.25f;    // Time to measure each block size candidate [s]
+        static constexpr float  IDISPLAY_TIMEOUT    = 1.0f;     // Inline display is considered to be hidden after 1 second [s]
+        static constexpr size_t METER_BLOCK         = 1024;     // Size of block processed by metering while it resides in L1 cache
+        static constexpr float  BYPASS_DRY_TIME     = 0.1f;     // Time to process dry signal after bypass switch, covers the crossfade [s]
 
         //-------------------------------------------------------------------------
         // Plugin factory
@@ -44,7 +55,7 @@ namespace lsp
             {
                 const meta::plugin_t   *metadata;
                 bool                    sc;
-                bool                    stereo;
+                uint8_t                 channels;
             } plugin_settings_t;
 
             static const meta::plugin_t *plugins[] =
@@ -52,28 +63,34 @@ namespace lsp
                 &meta::limiter_mono,
                 &meta::limiter_stereo,
                 &meta::sc_limiter_mono,
-                &meta::sc_limiter_stereo
+                &meta::sc_limiter_stereo,
+                &meta::limiter_5_1,
+                &meta::limiter_7_1,
+                &meta::limiter_7_1_4
             };
 
             static const plugin_settings_t plugin_settings[] =
             {
-                { &meta::limiter_mono,       false, false       },
-                { &meta::limiter_stereo,     false, true        },
-                { &meta::sc_limiter_mono,    true,  false       },
-                { &meta::sc_limiter_stereo,  true,  true        },
-
-                { NULL, 0, false }
+                { &meta::limiter_mono,       false, 1       },
+                { &meta::limiter_stereo,     false, 2       },
+                { &meta::sc_limiter_mono,    true,  1       },
+                { &meta::sc_limiter_stereo,  true,  2       },
+                { &meta::limiter_5_1,        false, 6       },
+                { &meta::limiter_7_1,        false, 8       },
+                { &meta::limiter_7_1_4,      false, 12      },
+
+                { NULL, 0, 0 }
             };
 
             static plug::Module *plugin_factory(const meta::plugin_t *meta)
             {
                 for (const plugin_settings_t *s = plugin_settings; s->metadata != NULL; ++s)
                     if (s->metadata == meta)
-                        return new limiter(s->metadata, s->sc, s->stereo);
+                        return new limiter(s->metadata, s->sc, s->channels);
                 return NULL;
             }
 
-            static plug::Factory factory(plugin_factory, plugins, 4);
+            static plug::Factory factory(plugin_factory, plugins, 7);
 
             typedef struct true_peak_mode_t
             {
@@ -81,6 +98,128 @@ namespace lsp
                 dspu::over_mode_t   modes[2];
             } true_peak_mode_t;
 
+            /**
+             * Update the meter graph and compute the peak value of the buffer. The buffer is processed
+             * in small blocks, so the data is fetched from memory once and then is read from L1 cache.
+             *
+             * @param graph meter graph to update, may be NULL
+             * @param src source buffer
+             * @param count number of samples
+             * @return maximum value of the buffer
+             */
+            static float graph_max(dspu::MeterGraph *graph, const float *src, size_t count)
+            {
+                float peak  = (count > 0) ? src[0] : 0.0f;
+                for (size_t n; count > 0; count -= n, src += n)
+                {
+                    n           = lsp_min(count, METER_BLOCK);
+                    if (graph != NULL)
+                        graph->process(src, n);
+                    peak        = lsp_max(peak, dsp::max(src, n));
+                }
+                return peak;
+            }
+
+            /**
+             * Update the meter graph and compute the minimum value of the buffer in one sweep over the data
+             *
+             * @param graph meter graph to update, may be NULL
+             * @param src source buffer
+             * @param count number of samples
+             * @return minimum value of the buffer
+             */
+            static float graph_min(dspu::MeterGraph *graph, const float *src, size_t count)
+            {
+                float value = (count > 0) ? src[0] : 0.0f;
+                for (size_t n; count > 0; count -= n, src += n)
+                {
+                    n           = lsp_min(count, METER_BLOCK);
+                    if (graph != NULL)
+                        graph->process(src, n);
+                    value       = lsp_min(value, dsp::min(src, n));
+                }
+                return value;
+            }
+
+            /**
+             * Count dots produced by the meter graph for the number of samples passed to it. The counter
+             * follows dspu::MeterGraph: the dot is emitted and the period restarts when the number of
+             * accumulated samples reaches the period
+             *
+             * @param phase number of samples accumulated since the last dot
+             * @param period number of samples per dot
+             * @param count number of samples passed to the meter graph
+             * @return number of produced dots
+             */
+            static size_t graph_dots(size_t *phase, size_t period, size_t count)
+            {
+                size_t dots     = 0;
+                size_t n        = *phase;
+                while (count > 0)
+                {
+                    const size_t to_do  = lsp_min(count, period - lsp_min(n, period));
+                    n              += to_do;
+                    count          -= to_do;
+                    if (n >= period)
+                    {
+                        ++dots;
+                        n               = 0;
+                    }
+                }
+                *phase          = n;
+                return dots;
+            }
+
+            /**
+             * Get the time for profiling of processing stages
+             * @return time [ns]
+             */
+            static inline wsize_t profile_time()
+            {
+                system::time_t ts;
+                system::get_time(&ts);
+                return wsize_t(ts.seconds) * 1000000000U + ts.nanos;
+            }
+
+            /**
+             * Add the time elapsed since the start of the stage to the counter of the stage
+             *
+             * @param counter counter of the stage
+             * @param start start time of the stage [ns]
+             * @return current time which is the start time of the next stage [ns]
+             */
+            static inline wsize_t profile_stage(wsize_t *counter, wsize_t start)
+            {
+                const wsize_t now   = profile_time();
+                if (now > start)    // The clock may be adjusted by the system
+                    *counter           += now - start;
+                return now;
+            }
+
+            /**
+             * Detect the size of the per-core cache that should hold the working set of the block
+             * @return cache size [bytes]
+             */
+            static size_t detect_cache_size()
+            {
+            #if defined(PLATFORM_POSIX) && defined(_SC_LEVEL2_CACHE_SIZE)
+                const long size = sysconf(_SC_LEVEL2_CACHE_SIZE);
+                if (size > 0)
+                    return size;
+            #endif /* _SC_LEVEL2_CACHE_SIZE */
+                return LIMIT_CACHE_SIZE;
+            }
+
+            /**
+             * Get the maximum block size that fits the buffers
+             * @param times oversampling factor
+             * @return maximum block size at the original sample rate
+             */
+            static inline size_t max_block_size(size_t times)
+            {
+                return (LIMIT_BUFSIZE / times) & (~(LIMIT_BUFMULTIPLE-1));
+            }
+
             static const true_peak_mode_t true_peak_modes[] =
             {
                 { 0,            { dspu::OM_LANCZOS_8X16BIT, dspu::OM_LANCZOS_8X24BIT}   },
@@ -91,26 +230,259 @@ namespace lsp
                 { 88200,        { dspu::OM_LANCZOS_2X16BIT, dspu::OM_LANCZOS_2X24BIT}   },
                 { 176400,       { dspu::OM_NONE, dspu::OM_NONE}                         },
             };
+
+            /**
+             * Apply gain to the signal, the gain is linearly ramped if it has changed
+             *
+             * @param dst destination buffer
+             * @param src source buffer
+             * @param from gain at the beginning of the buffer
+             * @param to gain at the end of the buffer
+             * @param count number of samples
+             */
+            static inline void apply_gain(float *dst, const float *src, float from, float to, size_t count)
+            {
+                if (from != to)
+                    dsp::lramp2(dst, src, from, to, count);
+                else
+                    dsp::mul_k3(dst, src, to, count);
+            }
+
+            typedef struct iir_coefs_t
+            {
+                const float        *vPath[2];           // Allpass coefficients of each polyphase path
+                uint32_t            nPath[2];           // Number of allpass sections in each polyphase path
+            } iir_coefs_t;
+
+            // Half-band polyphase IIR filters, each stage provides at least 96 dB of image rejection
+            // above 0.45 of the original sample rate. The first stage has the narrowest transition band,
+            // the further stages only have to reject images that lie far from the audio band.
+            static const float iir_2x_path0[]   = { 0.0358327884f, 0.2720401434f, 0.5720571972f, 0.8271247620f };
+            static const float iir_2x_path1[]   = { 0.1340901419f, 0.4243248713f, 0.7062921421f, 0.9415030942f };
+            static const float iir_4x_path0[]   = { 0.0661115458f, 0.6744637897f };
+            static const float iir_4x_path1[]   = { 0.2734570722f };
+            static const float iir_8x_path0[]   = { 0.1111192691f };
+            static const float iir_8x_path1[]   = { 0.5382890780f };
+
+            static const iir_coefs_t iir_coefs[] =
+            {
+                { { iir_2x_path0, iir_2x_path1 }, { 4, 4 } },
+                { { iir_4x_path0, iir_4x_path1 }, { 2, 1 } },
+                { { iir_8x_path0, iir_8x_path1 }, { 1, 1 } },
+            };
+
+            // Group delay of the whole upsampling and downsampling chain at low frequencies,
+            // in samples at the original sample rate, indexed by number of stages.
+            // The chain is not linear-phase: the group delay grows with frequency and reaches
+            // ~9.7/10.7/11.0 samples at 0.4*fs and ~16.3/17.3/17.6 samples at 0.45*fs for 1/2/3
+            // stages, so the reported latency compensates only the low-frequency content. The gain
+            // reduction stays aligned since the signal and the sidechain pass the same filters.
+            static const uint32_t iir_latency[] = { 0, 3, 4, 4 };
+
+            /**
+             * Decimate the oversampled sidechain signal with peak holding. Each output sample is the
+             * maximum absolute value of the current and the previous group of oversampled samples,
+             * so the gain computed for it is safe for both groups.
+             *
+             * @param dst destination buffer to store count samples
+             * @param src source buffer of count*factor samples
+             * @param factor oversampling factor
+             * @param count number of samples to produce
+             * @param last peak of the last group of the previous call, updated
+             */
+            static void peak_decimate(float *dst, const float *src, size_t factor, size_t count, float *last)
+            {
+                float prev      = *last;
+                for (size_t i=0; i<count; ++i, src += factor)
+                {
+                    const float peak    = dsp::abs_max(src, factor);
+                    dst[i]              = lsp_max(peak, prev);
+                    prev                = peak;
+                }
+                *last           = prev;
+            }
+
+            /**
+             * Interpolate the gain curve computed at base sample rate onto the oversampled signal. Each group
+             * of oversampled samples is ramped from the previous gain to the current one. Both gains are safe
+             * for the group delayed by one sample at base rate, so is any value between them.
+             *
+             * @param dst destination buffer to store count*factor samples
+             * @param src gain curve at base sample rate
+             * @param factor oversampling factor
+             * @param count number of samples in the gain curve
+             * @param last last gain of the previous call, updated
+             */
+            static void gain_interpolate(float *dst, const float *src, size_t factor, size_t count, float *last)
+            {
+                float prev      = *last;
+                for (size_t i=0; i<count; ++i, dst += factor)
+                {
+                    dsp::lramp_set1(dst, prev, src[i], factor);
+                    prev                = src[i];
+                }
+                *last           = prev;
+            }
+
+            /**
+             * Get the level of multi-resolution history for the history span
+             * @param span history span
+             * @return level of history
+             */
+            static size_t history_level(size_t span)
+            {
+                switch (span)
+                {
+                    case meta::limiter_metadata::HSPAN_32S:     return 3;
+                    case meta::limiter_metadata::HSPAN_64S:     return 4;
+                    case meta::limiter_metadata::HSPAN_256S:    return 6;
+                    default: break;
+                }
+                return 0;
+            }
+
+            /**
+             * Decimate the history to the width of the inline display. Each pixel shows the extreme
+             * value of history dots it covers, so short peaks do not disappear on narrow displays.
+             *
+             * @param dst destination buffer to store width values
+             * @param src history dots
+             * @param count number of history dots
+             * @param width width of the display
+             * @param minimum use minimum instead of maximum
+             */
+            static void idisplay_decimate(float *dst, const float *src, size_t count, size_t width, bool minimum)
+            {
+                for (size_t k=0; k<width; ++k)
+                {
+                    const size_t first  = (k * count) / width;
+                    const size_t last   = lsp_max(((k + 1) * count) / width, first + 1);
+                    dst[k]              = (minimum) ?
+                        dsp::min(&src[first], last - first) :
+                        dsp::max(&src[first], last - first);
+                }
+            }
+
+            static inline float iir_allpass(const float *k, float *s, size_t n, float x)
+            {
+                for (size_t i=0; i<n; ++i, s += 2)
+                {
+                    const float y   = k[i] * (x - s[1]) + s[0];
+                    s[0]            = x;
+                    s[1]            = y;
+                    x               = y;
+                }
+                return x;
+            }
+
+            /**
+             * Perform 2x upsampling with half-band polyphase IIR filter. The destination buffer may
+             * overlap the tail of the source buffer.
+             *
+             * @param k filter coefficients
+             * @param s filter state
+             * @param dst destination buffer to store 2*count samples
+             * @param src source buffer
+             * @param count number of samples in source buffer
+             */
+            static void iir_upsample_stage(const iir_coefs_t *k, float *s, float *dst, const float *src, size_t count)
+            {
+                float *s1       = &s[k->nPath[0] * 2];
+                for (size_t i=0; i<count; ++i, dst += 2)
+                {
+                    const float x   = src[i];
+                    dst[0]          = iir_allpass(k->vPath[0], s, k->nPath[0], x);
+                    dst[1]          = iir_allpass(k->vPath[1], s1, k->nPath[1], x);
+                }
+            }
+
+            /**
+             * Perform 2x downsampling with half-band polyphase IIR filter. The destination buffer may
+             * be the same as the source buffer.
+             *
+             * @param k filter coefficients
+             * @param s filter state
+             * @param dst destination buffer to store count samples
+             * @param src source buffer of 2*count samples
+             * @param count number of samples to produce
+             */
+            static void iir_downsample_stage(const iir_coefs_t *k, float *s, float *dst, const float *src, size_t count)
+            {
+                float *s1       = &s[k->nPath[0] * 2];
+                for (size_t i=0; i<count; ++i, src += 2)
+                {
+                    dst[i]          = 0.5f * (
+                        iir_allpass(k->vPath[0], s, k->nPath[0], src[1]) +
+                        iir_allpass(k->vPath[1], s1, k->nPath[1], src[0]));
+                }
+            }
         } /* inline namespace */
 
         //-------------------------------------------------------------------------
-        limiter::limiter(const meta::plugin_t *metadata, bool sc, bool stereo): plug::Module(metadata)
+        limiter::limiter(const meta::plugin_t *metadata, bool sc, size_t channels): plug::Module(metadata)
         {
-            nChannels       = (stereo) ? 2 : 1;
+            nChannels       = lsp_min(channels, meta::limiter_metadata::CHANNELS_MAX);
+            nLinkGroups     = 1;
             bSidechain      = sc;
+            bBypass         = false;
+            nBypassFade     = 0;
             bPause          = false;
             bClear          = false;
             bScListen       = false;
             vChannels       = NULL;
             vTime           = NULL;
             vIDisplay       = NULL;
+            vHistory        = NULL;
+            nHistPeriod     = 1;
+            nHistScPeriod   = 1;
+            nHistDots       = 0;
+            nHistSent       = 0;
+            nHistKey        = 0;
+            nHistLevel      = 0;
+            nOversampling   = 1;
+            nScOversampling = 1;
+            nIIRStages      = 0;
+            bGainDecim      = false;
+            bLinked         = false;
+            nLinkWarmup     = 0;
             nScMode         = SCM_INTERNAL;
             fInGain         = GAIN_AMP_0_DB;
             fOutGain        = GAIN_AMP_0_DB;
             fPreamp         = GAIN_AMP_0_DB;
             fStereoLink     = 1.0f;
+            fOldInGain      = GAIN_AMP_0_DB;
+            fOldOutGain     = GAIN_AMP_0_DB;
+            fOldPreamp      = GAIN_AMP_0_DB;
+            fOldStereoLink  = 1.0f;
+            fThresh         = GAIN_AMP_0_DB;
+            for (size_t i=0; i<P_TOTAL; ++i)
+                vParams[i]      = 0.0f;
+            bReconfigure    = true;
             pIDisplay       = NULL;
             bUISync         = true;
+            bReady          = false;
+            bUIActive       = false;
+            bMetering       = false;
+            bTelemetry      = false;
+            nTelPosition    = 0;
+            bProfile        = false;
+            for (size_t i=0; i<PS_TOTAL; ++i)
+                vProfile[i]     = 0;
+            nProfSamples    = 0;
+            fCpuLoad        = 0.0f;
+            nCacheSize      = LIMIT_CACHE_SIZE;
+            nBlockSize      = LIMIT_BUFSIZE;
+            bCalibrate      = false;
+            nCalibSamples   = 0;
+            nCalibTime      = 0;
+            nCalibBest      = 0;
+            fCalibCost      = 0.0f;
+            nIDisplayIdle   = 0;
+            nIDisplayDots   = 0;
+            bIDisplayDirty  = true;
+            sIDGeometry.nWidth  = 0;
+            sIDGeometry.nHeight = 0;
+            sIDGeometry.pBuffer = NULL;
 
             sPremix.fInToSc     = GAIN_AMP_M_INF_DB;
             sPremix.fInToLink   = GAIN_AMP_M_INF_DB;
@@ -119,7 +491,7 @@ namespace lsp
             sPremix.fScToIn     = GAIN_AMP_M_INF_DB;
             sPremix.fScToLink   = GAIN_AMP_M_INF_DB;
 
-            for (size_t i=0; i<2; ++i)
+            for (size_t i=0; i<meta::limiter_metadata::CHANNELS_MAX; ++i)
             {
                 sPremix.vIn[i]      = NULL;
                 sPremix.vOut[i]     = NULL;
@@ -160,6 +532,12 @@ namespace lsp
             pOversampling   = NULL;
             pDithering      = NULL;
             pStereoLink     = NULL;
+            pLfeLink        = NULL;
+            pGainDecim      = NULL;
+            pHistSpan       = NULL;
+            pTelemetryOn    = NULL;
+            pTelemetry      = NULL;
+            pCpuLoad        = NULL;
 
             pData           = NULL;
         }
@@ -177,15 +555,18 @@ namespace lsp
             vChannels       = new channel_t[nChannels];
             if (vChannels == NULL)
                 return;
+            nCacheSize      = detect_cache_size();
 
-            // Allocate temporary buffers
+            // Allocate temporary buffers, pre-mixing is available only for mono and stereo versions
             size_t c_data   = LIMIT_BUFSIZE * sizeof(float);
             size_t h_data   = meta::limiter_metadata::HISTORY_MESH_SIZE * sizeof(float);
+            size_t p_chan   = (nChannels <= 2) ? nChannels : 0;
             size_t allocate =
                 c_data * 4 * nChannels +    // channel_t buffers
-                c_data * nChannels * 3 +    // sPremix
+                c_data * p_chan * 3 +       // sPremix
                 h_data +                    // vTimePoints
-                h_data;                     // vIDisplay
+                h_data +                    // vIDisplay
+                h_data;                     // vHistory
 
             uint8_t *ptr    = alloc_aligned<uint8_t>(pData, allocate, DEFAULT_ALIGN);
             if (ptr == NULL)
@@ -193,18 +574,16 @@ namespace lsp
 
             vTime           = advance_ptr_bytes<float>(ptr, h_data);
             vIDisplay       = advance_ptr_bytes<float>(ptr, h_data);
+            vHistory        = advance_ptr_bytes<float>(ptr, h_data);
 
             // Initialize pre-mix
-            for (size_t i=0; i<nChannels; ++i)
+            for (size_t i=0; i<p_chan; ++i)
             {
                 sPremix.vTmpIn[i]       = advance_ptr_bytes<float>(ptr, c_data);
                 sPremix.vTmpLink[i]     = advance_ptr_bytes<float>(ptr, c_data);
                 sPremix.vTmpSc[i]       = advance_ptr_bytes<float>(ptr, c_data);
             }
 
-            float lk_latency= int(dspu::samples_to_millis(MAX_SAMPLE_RATE, meta::limiter_metadata::OVERSAMPLING_MAX)) +
-                              meta::limiter_metadata::LOOKAHEAD_MAX + 1.0f;
-
             // Initialize channels
             for (size_t i=0; i<nChannels; ++i)
             {
@@ -220,17 +599,29 @@ namespace lsp
                 c->vScBuf       = advance_ptr_bytes<float>(ptr, c_data);
                 c->vGainBuf     = advance_ptr_bytes<float>(ptr, c_data);
                 c->vOutBuf      = advance_ptr_bytes<float>(ptr, c_data);
+                c->vLimitSc     = NULL;
+
+                c->fScPeak      = 0.0f;
+                c->fGainLast    = GAIN_AMP_0_DB;
+                c->fTelInPeak   = 0.0f;
+                c->fTelOutPeak  = 0.0f;
+                c->fTelGain     = GAIN_AMP_0_DB;
+                c->bTelAlr      = false;
+                for (size_t j=0; j<PS_TOTAL; ++j)
+                    c->vProfile[j]  = 0;
 
                 c->bOutVisible  = true;
                 c->bGainVisible = true;
                 c->bScVisible   = true;
+                c->nLinkGroup   = 0;
 
+                for (size_t j=0; j<G_TOTAL; ++j)
+                    c->vHistPhase[j]    = 0;
                 for (size_t j=0; j<G_TOTAL; ++j)
                     c->bVisible[j]  = true;
                 for (size_t j=0; j<G_TOTAL; ++j)
                     c->pVisible[j]  = NULL;
-                for (size_t j=0; j<G_TOTAL; ++j)
-                    c->pGraph[j]    = NULL;
+                c->pHistory     = NULL;
                 for (size_t j=0; j<G_TOTAL; ++j)
                     c->pMeter[j]    = NULL;
 
@@ -245,14 +636,7 @@ namespace lsp
                 if (!c->sScOver.init())
                     return;
 
-                // Initialize limiter with latency compensation gap
-                if (!c->sLimit.init(MAX_SAMPLE_RATE * meta::limiter_metadata::OVERSAMPLING_MAX, lk_latency))
-                    return;
-
-                if (!c->sDataDelay.init(dspu::millis_to_samples(MAX_SAMPLE_RATE * meta::limiter_metadata::OVERSAMPLING_MAX, lk_latency) + LIMIT_BUFSIZE))
-                    return;
-                if (!c->sDryDelay.init(dspu::millis_to_samples(MAX_SAMPLE_RATE, lk_latency + c->sOver.max_latency())))
-                    return;
+                // The limiter and delays are allocated by update_sample_rate() for the actual sample rate
             }
 
             lsp_assert(ptr <= &pData[allocate + DEFAULT_ALIGN]);
@@ -272,21 +656,25 @@ namespace lsp
                     BIND_PORT(vChannels[i].pSc);
             }
 
-            SKIP_PORT("Shared memory link name");
-            for (size_t i=0; i<nChannels; ++i)
-                BIND_PORT(vChannels[i].pShmIn);
-
-            // Pre-mixing ports
-            lsp_trace("Binding pre-mix ports");
-            SKIP_PORT("Show premix overlay");
-            BIND_PORT(sPremix.pInToLink);
-            BIND_PORT(sPremix.pLinkToIn);
-            BIND_PORT(sPremix.pLinkToSc);
-            if (bSidechain)
+            // Shared memory link and pre-mixing are available only for mono and stereo versions
+            if (nChannels <= 2)
             {
-                BIND_PORT(sPremix.pInToSc);
-                BIND_PORT(sPremix.pScToIn);
-                BIND_PORT(sPremix.pScToLink);
+                SKIP_PORT("Shared memory link name");
+                for (size_t i=0; i<nChannels; ++i)
+                    BIND_PORT(vChannels[i].pShmIn);
+
+                // Pre-mixing ports
+                lsp_trace("Binding pre-mix ports");
+                SKIP_PORT("Show premix overlay");
+                BIND_PORT(sPremix.pInToLink);
+                BIND_PORT(sPremix.pLinkToIn);
+                BIND_PORT(sPremix.pLinkToSc);
+                if (bSidechain)
+                {
+                    BIND_PORT(sPremix.pInToSc);
+                    BIND_PORT(sPremix.pScToIn);
+                    BIND_PORT(sPremix.pScToLink);
+                }
             }
 
             // Bind common ports
@@ -311,9 +699,12 @@ namespace lsp
             BIND_PORT(pPause);
             BIND_PORT(pClear);
 
-            BIND_PORT(pScMode);
+            if (nChannels <= 2)
+                BIND_PORT(pScMode);
             if (nChannels > 1)
                 BIND_PORT(pStereoLink);
+            if (nChannels > 2)
+                BIND_PORT(pLfeLink);
 
             // Bind history ports for each channel
             lsp_trace("Binding history ports");
@@ -329,15 +720,43 @@ namespace lsp
                 for (size_t j=0; j<G_TOTAL; ++j)
                     BIND_PORT(c->pMeter[j]);
 
-                // Graph ports
-                for (size_t j=0; j<G_TOTAL; ++j)
-                    BIND_PORT(c->pGraph[j]);
+                // Graph meshes of the first release, not used anymore
+                if (nChannels <= 2)
+                {
+                    SKIP_PORT("Input graph");
+                    SKIP_PORT("Output graph");
+                    SKIP_PORT("Sidechain graph");
+                    SKIP_PORT("Gain graph");
+                }
             }
 
+            // Bind ports added after the first release
+            lsp_trace("Binding extra ports");
+            BIND_PORT(pGainDecim);
+            BIND_PORT(pHistSpan);
+            BIND_PORT(pTelemetryOn);
+            BIND_PORT(pTelemetry);
+            BIND_PORT(pCpuLoad);
+
+            // Bind history streams
+            for (size_t i=0; i<nChannels; ++i)
+                BIND_PORT(vChannels[i].pHistory);
+
             float delta     = meta::limiter_metadata::HISTORY_TIME / (meta::limiter_metadata::HISTORY_MESH_SIZE - 1);
             for (size_t i=0; i<meta::limiter_metadata::HISTORY_MESH_SIZE; ++i)
                 vTime[i]    = meta::limiter_metadata::HISTORY_TIME - i*delta;
 
+            // Initialize multi-resolution history
+            for (size_t i=0; i<nChannels; ++i)
+            {
+                channel_t *c    = &vChannels[i];
+                for (size_t j=0; j<G_TOTAL; ++j)
+                {
+                    const float dfl = (j == G_GAIN) ? GAIN_AMP_0_DB : GAIN_AMP_M_INF_DB;
+                    c->sHistory[j].init(meta::limiter_metadata::HISTORY_LEVELS, meta::limiter_metadata::HISTORY_MESH_SIZE, dfl);
+                }
+            }
+
             // Initialize dither
             sDither.init();
         }
@@ -363,6 +782,10 @@ namespace lsp
                     c->sLimit.destroy();
                     c->sOver.destroy();
                     c->sScOver.destroy();
+                    c->sDataDelay.destroy();
+                    c->sDryDelay.destroy();
+                    for (size_t j=0; j<G_TOTAL; ++j)
+                        c->sHistory[j].destroy();
                 }
 
                 delete [] vChannels;
@@ -375,10 +798,110 @@ namespace lsp
             }
         }
 
+        bool limiter::init_delays(long sr)
+        {
+            // The buffers are sized for the actual sample rate but for the maximum oversampling, not for
+            // the current one. The oversampling mode is changed by update_settings() which is called by
+            // wrappers in the audio thread, where memory can not be allocated. Reallocation in a background
+            // task would need a second set of limiters and delay lines to swap in, and it would hold both sets
+            // while switching to the 8x mode, so it can not reduce the peak footprint below this one. Also the
+            // limiter and the data delay would lose their state on the swap, which the in-place reconfiguration
+            // avoids. This call happens outside of the audio thread, so the memory allocation is safe.
+            const size_t max_sample_rate    = sr * meta::limiter_metadata::OVERSAMPLING_MAX;
+            const float lk_latency          = int(dspu::samples_to_millis(sr, meta::limiter_metadata::OVERSAMPLING_MAX)) +
+                                              meta::limiter_metadata::LOOKAHEAD_MAX + 1.0f;
+
+            for (size_t i=0; i<nChannels; ++i)
+            {
+                channel_t *c = &vChannels[i];
+
+                c->sLimit.destroy();
+                c->sDataDelay.destroy();
+                c->sDryDelay.destroy();
+
+                // Initialize limiter with latency compensation gap
+                if (!c->sLimit.init(max_sample_rate, lk_latency))
+                    return false;
+                if (!c->sDataDelay.init(dspu::millis_to_samples(max_sample_rate, lk_latency) + LIMIT_BUFSIZE))
+                    return false;
+                if (!c->sDryDelay.init(dspu::millis_to_samples(sr, lk_latency) + c->sOver.max_latency()))
+                    return false;
+            }
+
+            return true;
+        }
+
+        void limiter::calibrate()
+        {
+            bCalibrate      = true;
+            update_block_size();
+        }
+
+        void limiter::update_block_size()
+        {
+            // The sidechain may be oversampled more than the signal
+            const size_t times      = lsp_max(nOversampling, nScOversampling);
+            const size_t max_size   = max_block_size(times);
+
+            // Calibration starts from the smallest block and doubles it after each measurement
+            if (bCalibrate)
+            {
+                nBlockSize              = LIMIT_BLOCK_MIN;
+                nCalibSamples           = 0;
+                nCalibTime              = 0;
+                nCalibBest              = 0;
+                fCalibCost              = 0.0f;
+                return;
+            }
+
+            // Data, sidechain, gain and output buffers of all channels at the oversampled rate and premix
+            // buffers, inputs and outputs at the original sample rate are touched by each block. The working
+            // set should take half of the cache, the rest is left to the limiter, delays and oversamplers.
+            const size_t premix     = (nChannels <= 2) ? 3 : 0;
+            const size_t bytes      = nChannels * (times * 4 + premix + 2) * sizeof(float);
+            const size_t size       = (nCacheSize / 2) / bytes;
+            nBlockSize              = lsp_limit(size & (~(LIMIT_BUFMULTIPLE-1)), LIMIT_BLOCK_MIN, max_size);
+        }
+
+        void limiter::calibrate_block_size(size_t samples, wsize_t time)
+        {
+            nCalibSamples          += samples;
+            nCalibTime             += time;
+            if (nCalibSamples < dspu::seconds_to_samples(fSampleRate, CALIBRATION_TIME))
+                return;
+
+            // Remember the fastest block size and try the next one
+            const float cost        = float(nCalibTime) / float(nCalibSamples);
+            if ((nCalibBest <= 0) || (cost < fCalibCost))
+            {
+                nCalibBest              = nBlockSize;
+                fCalibCost              = cost;
+            }
+            nCalibSamples           = 0;
+            nCalibTime              = 0;
+
+            const size_t max_size   = max_block_size(lsp_max(nOversampling, nScOversampling));
+            if (nBlockSize < max_size)
+            {
+                nBlockSize              = lsp_min(nBlockSize * 2, max_size);
+                return;
+            }
+
+            nBlockSize              = nCalibBest;
+            bCalibrate              = false;
+        }
+
         void limiter::update_sample_rate(long sr)
         {
+            // Delay lines and limiters are destroyed by the failed allocation, the plugin
+            // passes the input to the output until the next successful sample rate change
+            bReady                      = init_delays(sr);
+            if (!bReady)
+                lsp_warn("Could not allocate delay buffers for sample rate %d, the plugin is bypassed", int(sr));
+
             size_t max_sample_rate      = sr * meta::limiter_metadata::OVERSAMPLING_MAX;
-            size_t real_sample_rate     = vChannels[0].sOver.get_oversampling() * sr;
+            size_t real_sample_rate     = nOversampling * sr;
+            bReconfigure                = true;
             float scaling_factor        = meta::limiter_metadata::HISTORY_TIME / meta::limiter_metadata::HISTORY_MESH_SIZE;
 
             size_t max_samples_per_dot  = dspu::seconds_to_samples(max_sample_rate, scaling_factor);
@@ -401,10 +924,15 @@ namespace lsp
                     const float dfl = (j == G_GAIN) ? GAIN_AMP_0_DB : GAIN_AMP_M_INF_DB;
                     c->sGraph[j].init(meta::limiter_metadata::HISTORY_MESH_SIZE, max_samples_per_dot, dfl);
                     c->sGraph[j].set_period(real_samples_per_dot);
+                    c->vHistPhase[j]    = 0;
                 }
 
                 c->sGraph[G_GAIN].set_method(dspu::MM_ABS_MINIMUM);
             }
+
+            nHistPeriod                 = lsp_max(real_samples_per_dot, size_t(1));
+            nHistScPeriod               = nHistPeriod;
+            nTelPosition                = 0;
         }
 
         dspu::over_mode_t limiter::get_oversampling_mode(size_t mode)
@@ -442,6 +970,13 @@ namespace lsp
                     return true_peak_modes[best].modes[index];
                 }
 
+                case meta::limiter_metadata::OVS_SIDECHAIN_2X:
+                    return dspu::OM_LANCZOS_2X24BIT;
+                case meta::limiter_metadata::OVS_SIDECHAIN_4X:
+                    return dspu::OM_LANCZOS_4X24BIT;
+                case meta::limiter_metadata::OVS_SIDECHAIN_8X:
+                    return dspu::OM_LANCZOS_8X24BIT;
+
                 case meta::limiter_metadata::OVS_NONE:
                 default:
                     return dspu::OM_NONE;
@@ -520,6 +1055,28 @@ namespace lsp
             return 0;
         }
 
+        size_t limiter::get_iir_stages(size_t mode)
+        {
+            switch (mode)
+            {
+                case meta::limiter_metadata::OVS_LOW_LATENCY_2X:
+                    return 1;
+                case meta::limiter_metadata::OVS_LOW_LATENCY_4X:
+                    return 2;
+                case meta::limiter_metadata::OVS_LOW_LATENCY_8X:
+                    return 3;
+
+                default:
+                    break;
+            }
+            return 0;
+        }
+
+        bool limiter::get_sidechain_only(size_t mode)
+        {
+            return (mode >= meta::limiter_metadata::OVS_SIDECHAIN_2X) && (mode <= meta::limiter_metadata::OVS_SIDECHAIN_8X);
+        }
+
         uint32_t limiter::decode_sidechain_mode(uint32_t mode)
         {
             if (bSidechain)
@@ -545,12 +1102,63 @@ namespace lsp
             return SCM_INTERNAL;
         }
 
+        size_t limiter::oversampler_latency() const
+        {
+            return (nIIRStages > 0) ? iir_latency[nIIRStages] : vChannels[0].sScOver.latency();
+        }
+
+        size_t limiter::limiter_latency() const
+        {
+            // The gain computed at base sample rate is applied to the signal delayed by one more sample
+            const channel_t *c  = &vChannels[0];
+            return (bGainDecim) ? c->sLimit.get_latency() + 1 : c->sLimit.get_latency() / nOversampling;
+        }
+
+        size_t limiter::data_latency() const
+        {
+            // If only the sidechain is oversampled, the data should be also delayed by the latency of oversampler
+            return (nScOversampling > nOversampling) ?
+                limiter_latency() + oversampler_latency() :
+                limiter_latency();
+        }
+
+        void limiter::upsample(dspu::Oversampler *ovs, iir_stage_t *iir, float *dst, const float *src, size_t count)
+        {
+            if (nIIRStages <= 0)
+            {
+                ovs->upsample(dst, src, count);
+                return;
+            }
+
+            // Intermediate data of each stage is placed at the tail of the destination buffer,
+            // so the next stage can produce twice more samples in the same buffer
+            const size_t total  = count << nIIRStages;
+            for (size_t i=0; i<nIIRStages; ++i, count <<= 1)
+            {
+                float *out          = &dst[total - (count << 1)];
+                iir_upsample_stage(&iir_coefs[i], iir[i].vUp, out, src, count);
+                src                 = out;
+            }
+        }
+
+        void limiter::downsample(dspu::Oversampler *ovs, iir_stage_t *iir, float *dst, const float *src, size_t count)
+        {
+            if (nIIRStages <= 0)
+            {
+                ovs->downsample(dst, src, count);
+                return;
+            }
+
+            for (size_t i=nIIRStages; i > 0; --i)
+            {
+                iir_downsample_stage(&iir_coefs[i-1], iir[i-1].vDown, dst, src, count << (i-1));
+                src                 = dst;
+            }
+        }
+
         void limiter::sync_latency()
         {
-            channel_t *c = &vChannels[0];
-            size_t latency =
-                    c->sLimit.get_latency() / c->sScOver.get_oversampling()
-                    + c->sScOver.latency();
+            size_t latency = limiter_latency() + oversampler_latency();
 
             for (size_t i=0; i<nChannels; ++i)
                 vChannels[i].sDryDelay.set_delay(latency);
@@ -567,97 +1175,266 @@ namespace lsp
             sPremix.fScToLink   = (sPremix.pScToLink != NULL)   ? sPremix.pScToLink->value()    : GAIN_AMP_M_INF_DB;
         }
 
+        uint32_t limiter::update_params()
+        {
+            // Subsystems that need to be updated when the parameter changes
+            static const uint32_t flags[P_TOTAL] =
+            {
+                UPD_OVERSAMPLING,       // P_OVERSAMPLING
+                UPD_DITHER,             // P_DITHERING
+                UPD_LIMITER,            // P_MODE
+                UPD_LIMITER,            // P_LOOKAHEAD
+                UPD_LIMITER,            // P_ATTACK
+                UPD_LIMITER,            // P_RELEASE
+                UPD_LIMITER,            // P_KNEE_LEVEL
+                UPD_LIMITER,            // P_KNEE_SMOOTH
+                UPD_LIMITER,            // P_ALR_ON
+                UPD_LIMITER,            // P_ALR_ATTACK
+                UPD_LIMITER,            // P_ALR_RELEASE
+                UPD_LIMITER,            // P_BOOST
+                UPD_LINK,               // P_LFE_LINK
+                UPD_OVERSAMPLING        // P_GAIN_DECIM
+            };
+
+            const float values[P_TOTAL] =
+            {
+                pOversampling->value(),
+                pDithering->value(),
+                pMode->value(),
+                pLookahead->value(),
+                pAttack->value(),
+                pRelease->value(),
+                pKneeLevel->value(),
+                pKneeSmooth->value(),
+                pAlrOn->value(),
+                pAlrAttack->value(),
+                pAlrRelease->value(),
+                pBoost->value(),
+                (pLfeLink != NULL) ? pLfeLink->value() : 1.0f,
+                pGainDecim->value()
+            };
+
+            uint32_t dirty              = (bReconfigure) ? UPD_ALL : 0;
+            for (size_t i=0; i<P_TOTAL; ++i)
+            {
+                if (vParams[i] == values[i])
+                    continue;
+                vParams[i]                  = values[i];
+                dirty                      |= flags[i];
+            }
+            bReconfigure                = false;
+
+            return dirty;
+        }
+
         void limiter::update_settings()
         {
+            // Settings are applied by the next successful sample rate change
+            if (!bReady)
+                return;
+
+            // Premix, gains and linking are plain values ramped by process(), so they are always applied
             update_premix();
+            bIDisplayDirty              = true;
+
+            // Changing the history span requires full history to be sent to UI
+            const size_t hist_level     = history_level(size_t(pHistSpan->value()));
+            if (hist_level != nHistLevel)
+            {
+                nHistLevel                  = hist_level;
+                nHistSent                   = nHistDots >> nHistLevel;
+                bUISync                     = true;
+            }
 
+            const bool reset            = bReconfigure;
             bPause                      = pPause->value() >= 0.5f;
             bClear                      = pClear->value() >= 0.5f;
 
-            size_t ovs_mode             = pOversampling->value();
-            dspu::over_mode_t mode      = get_oversampling_mode(ovs_mode);
-            bool filtering              = get_filtering(ovs_mode);
-            size_t dither               = get_dithering(pDithering->value());
-            float scaling_factor        = meta::limiter_metadata::HISTORY_TIME / meta::limiter_metadata::HISTORY_MESH_SIZE;
-
             bool bypass                 = pBypass->value() >= 0.5f;
-            float thresh                = pThresh->value();
-            float lk_ahead              = pLookahead->value();
-            float attack                = pAttack->value();
-            float release               = pRelease->value();
-            const float knee_level      = pKneeLevel->value();
-            const float knee_smooth     = dspu::db_to_gain(pKneeSmooth->value());
-            bool alr_on                 = pAlrOn->value() >= 0.5f;
-            float alr_attack            = pAlrAttack->value();
-            float alr_release           = pAlrRelease->value();
-            fStereoLink                 = (pStereoLink != NULL) ? pStereoLink->value()*0.01f : 1.0f;
-            nScMode                     = decode_sidechain_mode(pScMode->value());
+            if ((bypass != bBypass) || (reset))
+            {
+                if (bypass != bBypass)
+                    nBypassFade                 = dspu::seconds_to_samples(fSampleRate, BYPASS_DRY_TIME);
+                bBypass                     = bypass;
+                for (size_t i=0; i<nChannels; ++i)
+                    vChannels[i].sBypass.set_bypass(bypass);
+            }
 
-            bool boost                  = pBoost->value();
-            fOutGain                    = pOutGain->value();
-            if (boost)
-                fOutGain                   /= thresh;
+            nScMode                     = (pScMode != NULL) ? decode_sidechain_mode(pScMode->value()) : SCM_INTERNAL;
 
+            const float thresh          = pThresh->value();
+            const bool boost            = pBoost->value() >= 0.5f;
+            fStereoLink                 = (pStereoLink != NULL) ? pStereoLink->value()*0.01f : 1.0f;
             fInGain                     = pInGain->value();
-
             fPreamp                     = pPreamp->value();
-            dspu::limiter_mode_t op_mode= get_limiter_mode(pMode->value());
+            fOutGain                    = pOutGain->value();
+            if (boost)
+                fOutGain                   /= thresh;
 
-            sDither.set_bits(dither);
+            if (reset)
+            {
+                fOldInGain                  = fInGain;
+                fOldOutGain                 = fOutGain;
+                fOldPreamp                  = fPreamp;
+                fOldStereoLink              = fStereoLink;
+            }
 
+            // Update visibility of graphs, the surround UI shows only output and gain graphs
             for (size_t i=0; i<nChannels; ++i)
             {
                 channel_t *c = &vChannels[i];
+                for (size_t j=0; j<G_TOTAL; ++j)
+                {
+                    const bool shown    = (nChannels <= 2) || (j == G_OUT) || (j == G_GAIN);
+                    const bool visible  = (shown) && (c->pVisible[j]->value() >= 0.5f);
+                    if ((visible) && (!c->bVisible[j]))
+                    {
+                        // History was not updated while the graph was hidden, the UI should drop it too
+                        c->sGraph[j].clear();
+                        c->sHistory[j].clear();
+                        c->vHistPhase[j]    = 0;
+                        bUISync             = true;
+                    }
+                    c->bVisible[j]      = visible;
+                }
+            }
+
+            // Apply changes only to affected subsystems
+            const uint32_t dirty        = update_params();
 
-                // Update settings for each channel
-                c->sBypass.set_bypass(bypass);
-                c->sOver.set_mode(mode);
-                c->sOver.set_filtering(filtering);
-                if (c->sOver.modified())
-                    c->sOver.update_settings();
+            if (dirty & UPD_DITHER)
+                sDither.set_bits(get_dithering(pDithering->value()));
 
-                c->sScOver.set_mode(mode);
-                c->sScOver.set_filtering(false);
-                if (c->sScOver.modified())
-                    c->sScOver.update_settings();
+            if (dirty & UPD_LINK)
+            {
+                // The LFE channel forms its own linking group if it is not linked to other channels
+                const bool lfe_link         = (pLfeLink != NULL) ? pLfeLink->value() >= 0.5f : true;
+                nLinkGroups                 = ((nChannels > meta::limiter_metadata::LFE_CHANNEL) && (!lfe_link)) ? 2 : 1;
+                for (size_t i=0; i<nChannels; ++i)
+                    vChannels[i].nLinkGroup     = ((nLinkGroups > 1) && (i == meta::limiter_metadata::LFE_CHANNEL)) ? 1 : 0;
+            }
+
+            if (dirty & UPD_OVERSAMPLING)
+            {
+                const size_t ovs_mode       = pOversampling->value();
+                const dspu::over_mode_t mode= get_oversampling_mode(ovs_mode);
+                const bool filtering        = get_filtering(ovs_mode);
+                const size_t iir_stages     = get_iir_stages(ovs_mode);
+                const bool sc_only          = get_sidechain_only(ovs_mode);
+                const float scaling_factor  = meta::limiter_metadata::HISTORY_TIME / meta::limiter_metadata::HISTORY_MESH_SIZE;
+
+                // Reset the state of low-latency oversampler if it has been reconfigured
+                if (iir_stages != nIIRStages)
+                {
+                    nIIRStages                  = iir_stages;
+                    for (size_t i=0; i<nChannels; ++i)
+                    {
+                        channel_t *c = &vChannels[i];
+                        for (size_t j=0; j<IIR_STAGES_MAX; ++j)
+                        {
+                            dsp::fill_zero(c->vIIROver[j].vUp, IIR_PATH_MAX * 4);
+                            dsp::fill_zero(c->vIIROver[j].vDown, IIR_PATH_MAX * 4);
+                            dsp::fill_zero(c->vIIRScOver[j].vUp, IIR_PATH_MAX * 4);
+                            dsp::fill_zero(c->vIIRScOver[j].vDown, IIR_PATH_MAX * 4);
+                        }
+                    }
+                }
+
+                for (size_t i=0; i<nChannels; ++i)
+                {
+                    channel_t *c = &vChannels[i];
+
+                    c->sOver.set_mode((sc_only) ? dspu::OM_NONE : mode);
+                    c->sOver.set_filtering(filtering);
+                    if (c->sOver.modified())
+                        c->sOver.update_settings();
+
+                    c->sScOver.set_mode(mode);
+                    c->sScOver.set_filtering(false);
+                    if (c->sScOver.modified())
+                        c->sScOver.update_settings();
+
+                    nOversampling               = (nIIRStages > 0) ? (1 << nIIRStages) : c->sOver.get_oversampling();
+                    nScOversampling             = (nIIRStages > 0) ? (1 << nIIRStages) : c->sScOver.get_oversampling();
+
+                    // With sidechain-only oversampling the gain is always computed at base sample rate
+                    bGainDecim                  = (nScOversampling > 1) && ((sc_only) || (pGainDecim->value() >= 0.5f));
+                    const size_t real_sample_rate       = nOversampling * fSampleRate;
+                    const size_t real_samples_per_dot   = dspu::seconds_to_samples(real_sample_rate, scaling_factor);
+                    const size_t sc_samples_per_dot     = dspu::seconds_to_samples(nScOversampling * fSampleRate, scaling_factor);
+                    const size_t limiter_sample_rate    = (bGainDecim) ? size_t(fSampleRate) : real_sample_rate;
+
+                    // Cleanup the data delay if limiter's sample rate is going to chane
+                    if (c->sLimit.sample_rate() != limiter_sample_rate)
+                        c->sDataDelay.clear();
+                    c->sLimit.set_sample_rate(limiter_sample_rate);
+                    c->fScPeak                  = 0.0f;
+                    c->fGainLast                = GAIN_AMP_0_DB;
+
+                    // Update meters
+                    for (size_t j=0; j<G_TOTAL; ++j)
+                        c->sGraph[j].set_period((j == G_SC) ? sc_samples_per_dot : real_samples_per_dot);
+                }
 
-                size_t real_sample_rate     = c->sOver.get_oversampling() * fSampleRate;
-                size_t real_samples_per_dot = dspu::seconds_to_samples(real_sample_rate, scaling_factor);
+                // Count history dots the same way as meter graphs produce them
+                nHistPeriod                 = lsp_max(dspu::seconds_to_samples(nOversampling * fSampleRate, scaling_factor), size_t(1));
+                nHistScPeriod               = lsp_max(dspu::seconds_to_samples(nScOversampling * fSampleRate, scaling_factor), size_t(1));
+
+                // The working set of the block depends on the oversampling
+                update_block_size();
+            }
+
+            if (dirty & (UPD_OVERSAMPLING | UPD_LIMITER))
+            {
+                const float lk_ahead        = pLookahead->value();
+                const float attack          = pAttack->value();
+                const float release         = pRelease->value();
+                const float knee_level      = pKneeLevel->value();
+                const float knee_smooth     = dspu::db_to_gain(pKneeSmooth->value());
+                const bool alr_on           = pAlrOn->value() >= 0.5f;
+                const float alr_attack      = pAlrAttack->value();
+                const float alr_release     = pAlrRelease->value();
+                const dspu::limiter_mode_t op_mode = get_limiter_mode(pMode->value());
 
                 // Update lookahead because oversampling adds extra latency
-                float lk_ahead_ch = lk_ahead + dspu::samples_to_millis(fSampleRate, c->sScOver.latency());
+                const float lk_ahead_ch     = lk_ahead + dspu::samples_to_millis(fSampleRate, oversampler_latency());
+                fThresh                     = thresh;
 
-                // Cleanup the data delay if limiter's sample rate is going to chane
-                if (c->sLimit.sample_rate() != real_sample_rate)
-                    c->sDataDelay.clear();
+                for (size_t i=0; i<nChannels; ++i)
+                {
+                    channel_t *c = &vChannels[i];
+
+                    // Update settings for limiter
+                    c->sLimit.set_mode(op_mode);
+                    c->sLimit.set_lookahead(lk_ahead_ch);
+                    c->sLimit.set_threshold(thresh, !boost);
+                    c->sLimit.set_attack(attack);
+                    c->sLimit.set_release(release);
+                    c->sLimit.set_knee(knee_level);
+                    c->sLimit.set_alr_knee(knee_smooth);
+                    c->sLimit.set_alr(alr_on);
+                    c->sLimit.set_alr_attack(alr_attack);
+                    c->sLimit.set_alr_release(alr_release);
+                    c->sLimit.update_settings();
+
+                    // Update the data delay
+                    c->sDataDelay.set_delay((bGainDecim) ? data_latency() * nOversampling : c->sLimit.get_latency());
+                }
 
-                // Update settings for limiter
-                c->sLimit.set_mode(op_mode);
-                c->sLimit.set_sample_rate(real_sample_rate);
-                c->sLimit.set_lookahead(lk_ahead_ch);
-                c->sLimit.set_threshold(thresh, !boost);
-                c->sLimit.set_attack(attack);
-                c->sLimit.set_release(release);
-                c->sLimit.set_knee(knee_level);
-                c->sLimit.set_alr_knee(knee_smooth);
-                c->sLimit.set_alr(alr_on);
-                c->sLimit.set_alr_attack(alr_attack);
-                c->sLimit.set_alr_release(alr_release);
-                c->sLimit.update_settings();
-
-                // Update the data delay
-                c->sDataDelay.set_delay(c->sLimit.get_latency());
-
-                // Update meters
-                for (size_t j=0; j<G_TOTAL; ++j)
+                // Report latency
+                sync_latency();
+            }
+            else if (thresh != fThresh)
+            {
+                // The threshold change does not require the full reconfiguration of the limiter
+                fThresh                     = thresh;
+                for (size_t i=0; i<nChannels; ++i)
                 {
-                    c->sGraph[j].set_period(real_samples_per_dot);
-                    c->bVisible[j]  = c->pVisible[j]->value() >= 0.5f;
+                    channel_t *c = &vChannels[i];
+                    c->sLimit.set_threshold(thresh, !boost);
+                    c->sLimit.update_settings();
                 }
             }
-
-            // Report latency
-            sync_latency();
         }
 
         void limiter::premix_channel(uint32_t channel, size_t count)
@@ -776,157 +1553,463 @@ namespace lsp
             }
         }
 
-        void limiter::process(size_t samples)
+        void limiter::link_gains(size_t samples)
         {
-            // Bind audio ports
-            for (size_t i=0; i<nChannels; ++i)
-            {
-                channel_t *c        = &vChannels[i];
-                sPremix.vIn[i]      = c->pIn->buffer<float>();
-                sPremix.vOut[i]     = c->pOut->buffer<float>();
-                sPremix.vSc[i]      = (c->pSc != NULL) ? c->pSc->buffer<float>() : NULL;
-                sPremix.vLink[i]    = NULL;
-
-                core::AudioBuffer *buf = (c->pShmIn != NULL) ? c->pShmIn->buffer<core::AudioBuffer>() : NULL;
-                if ((buf != NULL) && (buf->active()))
-                    sPremix.vLink[i]    = buf->buffer();
-            }
+            if ((nChannels < 2) || ((fStereoLink <= 0.0f) && (fOldStereoLink <= 0.0f)))
+                return;
 
-            // Get oversampling times
-            size_t times        = vChannels[0].sOver.get_oversampling();
-            size_t buf_size     = (LIMIT_BUFSIZE / times) & (~(LIMIT_BUFMULTIPLE-1));
+            // Fully linked channels are processed by limit_linked(), linking is ramped from
+            // fOldStereoLink to fStereoLink after the change of the parameter.
+            // The output buffer of the first channel is not used at this stage and serves as temporary storage.
+            float *gmin     = vChannels[0].vOutBuf;
 
-            // Process samples
-            for (size_t nsamples = samples; nsamples > 0; )
+            for (size_t group=0; group<nLinkGroups; ++group)
             {
-                // Perform oversampling of signal and sidechain
-                const size_t to_do      = lsp_min(buf_size, nsamples);
-                const size_t to_doxn    = to_do * times;
+                // Find minimum gain among all channels of the group
+                float *first    = NULL;
+                size_t linked   = 0;
 
-                // Pre-mix audio channels
                 for (size_t i=0; i<nChannels; ++i)
-                    premix_channel(i, to_do);
+                {
+                    channel_t *c    = &vChannels[i];
+                    if (c->nLinkGroup != group)
+                        continue;
 
-                // Do main stuff
+                    if (linked == 0)
+                        first           = c->vGainBuf;
+                    else if (linked == 1)
+                        dsp::pmin3(gmin, first, c->vGainBuf, samples);
+                    else
+                        dsp::pmin2(gmin, c->vGainBuf, samples);
+                    ++linked;
+                }
+
+                if (linked < 2)
+                    continue;
+
+                // Apply minimum gain to channels of the group
                 for (size_t i=0; i<nChannels; ++i)
                 {
                     channel_t *c    = &vChannels[i];
+                    if (c->nLinkGroup != group)
+                        continue;
 
-                    // Apply input gain if needed
-                    if (fInGain != GAIN_AMP_0_DB)
+                    // Partial linking: g = g + (min(g[0], ..., g[n]) - g) * link for each channel.
+                    if (fOldStereoLink != fStereoLink)
                     {
-                        dsp::mul_k3(c->vOutBuf, c->vIn, fInGain, to_do);
-                        c->sOver.upsample(c->vDataBuf, c->vOutBuf, to_do);
+                        dsp::lramp1(c->vGainBuf, 1.0f - fOldStereoLink, 1.0f - fStereoLink, samples);
+                        dsp::lramp_add2(c->vGainBuf, gmin, fOldStereoLink, fStereoLink, samples);
                     }
                     else
-                        c->sOver.upsample(c->vDataBuf, c->vIn, to_do);
+                        dsp::mix2(c->vGainBuf, gmin, 1.0f - fStereoLink, fStereoLink, samples);
+                }
+            }
+        }
+
+        void limiter::process_channel_pre(channel_t *c, size_t to_do)
+        {
+            const size_t to_doxn    = to_do * nOversampling;
+            const size_t to_doxs    = to_do * nScOversampling;
+            wsize_t time            = (bProfile) ? profile_time() : 0;
 
-                    // Process sidechain signal
-                    switch (nScMode)
+            // Apply input gain if needed
+            if ((fOldInGain != GAIN_AMP_0_DB) || (fInGain != GAIN_AMP_0_DB))
+            {
+                apply_gain(c->vOutBuf, c->vIn, fOldInGain, fInGain, to_do);
+                upsample(&c->sOver, c->vIIROver, c->vDataBuf, c->vOutBuf, to_do);
+            }
+            else
+                upsample(&c->sOver, c->vIIROver, c->vDataBuf, c->vIn, to_do);
+            if (bProfile)
+                time                    = profile_stage(&c->vProfile[PS_UPSAMPLE], time);
+
+            // Process sidechain signal
+            const float *sc         = c->vScBuf;
+            const bool preamp       = (fOldPreamp != GAIN_AMP_0_DB) || (fPreamp != GAIN_AMP_0_DB);
+            switch (nScMode)
+            {
+                case SCM_EXTERNAL:
+                    if (c->vSc != NULL)
                     {
-                        case SCM_EXTERNAL:
-                            if (c->vSc != NULL)
-                            {
-                                if (fPreamp != GAIN_AMP_0_DB)
-                                {
-                                    dsp::mul_k3(c->vOutBuf, c->vSc, fPreamp, to_do);
-                                    c->sScOver.upsample(c->vScBuf, c->vOutBuf, to_do);
-                                }
-                                else
-                                    c->sScOver.upsample(c->vScBuf, c->vSc, to_do);
-                            }
-                            else
-                                dsp::fill_zero(c->vScBuf, to_do);
-                            break;
-
-                        case SCM_LINK:
-                            if (c->vShmIn != NULL)
-                            {
-                                if (fPreamp != GAIN_AMP_0_DB)
-                                {
-                                    dsp::mul_k3(c->vOutBuf, c->vShmIn, fPreamp, to_do);
-                                    c->sScOver.upsample(c->vScBuf, c->vOutBuf, to_do);
-                                }
-                                else
-                                    c->sScOver.upsample(c->vScBuf, c->vShmIn, to_do);
-                            }
-                            else
-                                dsp::fill_zero(c->vScBuf, to_do);
-                            break;
-
-                        default:
-                            if (fPreamp != GAIN_AMP_0_DB)
-                                dsp::mul_k3(c->vScBuf, c->vDataBuf, fPreamp, to_doxn);
-                            else
-                                dsp::copy(c->vScBuf, c->vDataBuf, to_doxn);
-                            break;
+                        if (preamp)
+                        {
+                            apply_gain(c->vOutBuf, c->vSc, fOldPreamp, fPreamp, to_do);
+                            upsample(&c->sScOver, c->vIIRScOver, c->vScBuf, c->vOutBuf, to_do);
+                        }
+                        else
+                            upsample(&c->sScOver, c->vIIRScOver, c->vScBuf, c->vSc, to_do);
                     }
+                    else
+                        dsp::fill_zero(c->vScBuf, to_doxs);
+                    break;
 
-                    // Update graphs
-                    c->sGraph[G_IN].process(c->vDataBuf, to_doxn);
-                    c->sGraph[G_SC].process(c->vScBuf, to_doxn);
-                    c->pMeter[G_IN]->set_value(dsp::max(c->vDataBuf, to_doxn));
-                    c->pMeter[G_SC]->set_value(dsp::max(c->vScBuf, to_doxn));
+                case SCM_LINK:
+                    if (c->vShmIn != NULL)
+                    {
+                        if (preamp)
+                        {
+                            apply_gain(c->vOutBuf, c->vShmIn, fOldPreamp, fPreamp, to_do);
+                            upsample(&c->sScOver, c->vIIRScOver, c->vScBuf, c->vOutBuf, to_do);
+                        }
+                        else
+                            upsample(&c->sScOver, c->vIIRScOver, c->vScBuf, c->vShmIn, to_do);
+                    }
+                    else
+                        dsp::fill_zero(c->vScBuf, to_doxs);
+                    break;
 
-                    // Perform processing by limiter
-                    c->sLimit.process(c->vGainBuf, c->vScBuf, to_doxn);
-                    c->sDataDelay.process(c->vDataBuf, c->vDataBuf, to_doxn);
-                }
+                default:
+                    // Only the sidechain is oversampled: the input signal is at base sample rate
+                    if (nScOversampling > nOversampling)
+                    {
+                        if (preamp)
+                        {
+                            apply_gain(c->vOutBuf, c->vDataBuf, fOldPreamp, fPreamp, to_do);
+                            upsample(&c->sScOver, c->vIIRScOver, c->vScBuf, c->vOutBuf, to_do);
+                        }
+                        else
+                            upsample(&c->sScOver, c->vIIRScOver, c->vScBuf, c->vDataBuf, to_do);
+                    }
+                    // The limiter does not modify the sidechain data, so without pre-amplification
+                    // it can read the (not yet delayed) input signal directly
+                    else if (preamp)
+                        apply_gain(c->vScBuf, c->vDataBuf, fOldPreamp, fPreamp, to_doxn);
+                    else
+                        sc                  = c->vDataBuf;
+                    break;
+            }
+            if (bProfile)
+                time                    = profile_stage(&c->vProfile[PS_SIDECHAIN], time);
 
-                // Perform stereo linking
-                if (nChannels == 2)
+            // Update graphs, input and sidechain graphs of surround versions are never visible
+            if (bMetering)
+            {
+                c->pMeter[G_IN]->set_value(graph_max((c->bVisible[G_IN]) ? &c->sGraph[G_IN] : NULL, c->vDataBuf, to_doxn));
+                c->pMeter[G_SC]->set_value(graph_max((c->bVisible[G_SC]) ? &c->sGraph[G_SC] : NULL, sc, to_doxs));
+            }
+            if (bTelemetry)
+                c->fTelInPeak           = lsp_max(c->fTelInPeak, dsp::abs_max(c->vDataBuf, to_doxn));
+            if (bProfile)
+                time                    = profile_stage(&c->vProfile[PS_METERING], time);
+
+            // Prepare sidechain for the limiter. The output buffer is not used at this stage,
+            // with gain computation at base sample rate it holds decimated sidechain and gain curve
+            c->vLimitSc             = sc;
+            if (bGainDecim)
+            {
+                peak_decimate(c->vOutBuf, sc, nScOversampling, to_do, &c->fScPeak);
+                c->vLimitSc             = c->vOutBuf;
+            }
+            if (bProfile)
+                time                    = profile_stage(&c->vProfile[PS_SIDECHAIN], time);
+
+            // Perform processing by limiter, linked channels are processed after this stage.
+            // The data buffer is delayed by process_channel_post() since it may serve as the sidechain
+            if (!bLinked)
+                limit_channel(c, to_do);
+            if (bProfile)
+                profile_stage(&c->vProfile[PS_LIMIT], time);
+        }
+
+        void limiter::limit_channel(channel_t *c, size_t to_do)
+        {
+            if (bGainDecim)
+            {
+                float *dgain            = &c->vOutBuf[to_do];
+                c->sLimit.process(dgain, c->vLimitSc, to_do);
+                gain_interpolate(c->vGainBuf, dgain, nOversampling, to_do, &c->fGainLast);
+            }
+            else
+                c->sLimit.process(c->vGainBuf, c->vLimitSc, to_do * nOversampling);
+
+            // The state of the automatic level regulation is sampled at the end of each processed part of the block
+            if ((bTelemetry) && (c->sLimit.alr_active()))
+                c->bTelAlr              = true;
+        }
+
+        void limiter::limit_linked(size_t to_do, bool warmup)
+        {
+            const size_t to_doxn    = to_do * nOversampling;
+            const size_t count      = (bGainDecim) ? to_do : to_doxn;
+
+            for (size_t group=0; group<nLinkGroups; ++group)
+            {
+                // Build the sidechain of the group: maximum absolute value of sidechains of all channels
+                channel_t *lead         = NULL;
+                float *sc               = NULL;
+
+                for (size_t i=0; i<nChannels; ++i)
                 {
-                    float *cl = vChannels[0].vGainBuf;
-                    float *cr = vChannels[1].vGainBuf;
+                    channel_t *c            = &vChannels[i];
+                    if (c->nLinkGroup != group)
+                        continue;
 
-                    for (size_t i=0; i<to_doxn; ++i)
+                    if (lead == NULL)
                     {
-                        float gl = cl[i];
-                        float gr = cr[i];
-
-                        if (gl < gr)
-                            cr[i] = gr + (gl - gr) * fStereoLink;
-                        else
-                            cl[i] = gl + (gr - gl) * fStereoLink;
+                        lead                    = c;
+                        continue;
                     }
+                    if (sc == NULL)
+                    {
+                        // The decimated sidechain already resides in the output buffer, otherwise the
+                        // sidechain buffer is used since the limiter may read it from the data buffer
+                        sc                      = (bGainDecim) ? lead->vOutBuf : lead->vScBuf;
+                        dsp::pamax3(sc, lead->vLimitSc, c->vLimitSc, count);
+                    }
+                    else
+                        dsp::pamax2(sc, c->vLimitSc, count);
                 }
 
-                // Perform downsampling and post-processing of signal and sidechain
+                if (lead == NULL)
+                    continue;
+                if (sc != NULL)
+                    lead->vLimitSc          = sc;
+
+                // Run one limiter and apply its gain to all channels of the group
+                limit_channel(lead, to_do);
+
                 for (size_t i=0; i<nChannels; ++i)
                 {
-                    channel_t *c    = &vChannels[i];
+                    channel_t *c            = &vChannels[i];
+                    if ((c == lead) || (c->nLinkGroup != group))
+                        continue;
 
-                    // Update output signal: adjust gain
-                    dsp::fmmul_k3(c->vDataBuf, c->vGainBuf, fOutGain, to_doxn);
+                    // Keep the lookahead of the limiter up to date after the linking is released,
+                    // the computed gain is discarded
+                    if (warmup)
+                        limit_channel(c, to_do);
+                    dsp::copy(c->vGainBuf, lead->vGainBuf, to_doxn);
+                    c->fGainLast            = lead->fGainLast;
+                    c->bTelAlr              = lead->bTelAlr;
+                }
+            }
+        }
 
-                    // Do metering
-                    c->sGraph[G_OUT].process(c->vDataBuf, to_doxn);
-                    c->pMeter[G_OUT]->set_value(dsp::max(c->vDataBuf, to_doxn));
+        void limiter::process_channel_post(channel_t *c, size_t to_do)
+        {
+            const size_t to_doxn    = to_do * nOversampling;
+            wsize_t time            = (bProfile) ? profile_time() : 0;
 
-                    c->sGraph[G_GAIN].process(c->vGainBuf, to_doxn);
-                    float gain = dsp::min(c->vGainBuf, to_doxn);
-                    if (gain < 1.0f)
-                        c->sBlink.blink_min(gain);
+            // Delay the signal for the lookahead of the limiter, the sidechains of all channels
+            // have been consumed by the limiters at this moment
+            c->sDataDelay.process(c->vDataBuf, c->vDataBuf, to_doxn);
+            if (bProfile)
+                time                    = profile_stage(&c->vProfile[PS_LIMIT], time);
 
-                    // Do Downsampling and bypassing
-                    c->sOver.downsample(c->vOutBuf, c->vDataBuf, to_do);            // Downsample
-                    sDither.process(c->vOutBuf, c->vOutBuf, to_do);                 // Apply dithering
-                    c->sDryDelay.process(c->vDataBuf, c->vIn, to_do);               // Apply dry delay
-                    c->sBypass.process(c->vOut, c->vDataBuf, c->vOutBuf, to_do);    // Pass thru bypass
+            // Update output signal: adjust gain
+            if (fOldOutGain != fOutGain)
+            {
+                dsp::mul2(c->vDataBuf, c->vGainBuf, to_doxn);
+                dsp::lramp1(c->vDataBuf, fOldOutGain, fOutGain, to_doxn);
+            }
+            else
+                dsp::fmmul_k3(c->vDataBuf, c->vGainBuf, fOutGain, to_doxn);
+            if (bProfile)
+                time                    = profile_stage(&c->vProfile[PS_DOWNSAMPLE], time);
 
-                    // Update pointers
-                    c->vIn         += to_do;
-                    c->vOut        += to_do;
-                    if (c->vSc != NULL)
-                        c->vSc         += to_do;
-                    if (c->vShmIn != NULL)
-                        c->vShmIn      += to_do;
+            // Do metering
+            if (bMetering)
+            {
+                c->pMeter[G_OUT]->set_value(graph_max((c->bVisible[G_OUT]) ? &c->sGraph[G_OUT] : NULL, c->vDataBuf, to_doxn));
+
+                const float gain = graph_min((c->bVisible[G_GAIN]) ? &c->sGraph[G_GAIN] : NULL, c->vGainBuf, to_doxn);
+                if (gain < 1.0f)
+                    c->sBlink.blink_min(gain);
+            }
+            if (bTelemetry)
+            {
+                c->fTelOutPeak          = lsp_max(c->fTelOutPeak, dsp::abs_max(c->vDataBuf, to_doxn));
+                c->fTelGain             = lsp_min(c->fTelGain, dsp::min(c->vGainBuf, to_doxn));
+            }
+            if (bProfile)
+                time                    = profile_stage(&c->vProfile[PS_METERING], time);
+
+            // Do Downsampling and bypassing
+            downsample(&c->sOver, c->vIIROver, c->vOutBuf, c->vDataBuf, to_do); // Downsample
+            if (bProfile)
+                time                    = profile_stage(&c->vProfile[PS_DOWNSAMPLE], time);
+            sDither.process(c->vOutBuf, c->vOutBuf, to_do);                 // Apply dithering
+            if (bProfile)
+                time                    = profile_stage(&c->vProfile[PS_DITHER], time);
+            if ((bBypass) || (nBypassFade > 0))
+            {
+                c->sDryDelay.process(c->vDataBuf, c->vIn, to_do);           // Apply dry delay
+                c->sBypass.process(c->vOut, c->vDataBuf, c->vOutBuf, to_do);// Pass thru bypass
+            }
+            else
+            {
+                // The dry signal is not audible, just keep the delay line up to date
+                c->sDryDelay.append(c->vIn, to_do);
+                dsp::copy(c->vOut, c->vOutBuf, to_do);
+            }
+            if (bProfile)
+                profile_stage(&c->vProfile[PS_BYPASS], time);
+
+            // Update pointers
+            c->vIn         += to_do;
+            c->vOut        += to_do;
+            if (c->vSc != NULL)
+                c->vSc         += to_do;
+            if (c->vShmIn != NULL)
+                c->vShmIn      += to_do;
+        }
+
+        void limiter::process(size_t samples)
+        {
+            // Pass the input to the output if buffers could not be allocated for the sample rate
+            if (!bReady)
+            {
+                for (size_t i=0; i<nChannels; ++i)
+                {
+                    channel_t *c        = &vChannels[i];
+                    dsp::copy(c->pOut->buffer<float>(), c->pIn->buffer<float>(), samples);
+                }
+                return;
+            }
+
+            // The time of the whole block is always measured for the CPU load meter
+            const wsize_t start = profile_time();
+            wsize_t time        = start;
+
+            // Bind audio ports
+            for (size_t i=0; i<nChannels; ++i)
+            {
+                channel_t *c        = &vChannels[i];
+                sPremix.vIn[i]      = c->pIn->buffer<float>();
+                sPremix.vOut[i]     = c->pOut->buffer<float>();
+                sPremix.vSc[i]      = (c->pSc != NULL) ? c->pSc->buffer<float>() : NULL;
+                sPremix.vLink[i]    = NULL;
+
+                core::AudioBuffer *buf = (c->pShmIn != NULL) ? c->pShmIn->buffer<core::AudioBuffer>() : NULL;
+                if ((buf != NULL) && (buf->active()))
+                    sPremix.vLink[i]    = buf->buffer();
+            }
+
+            // Enable or disable metering
+            update_metering(samples);
+
+            // Reset telemetry of the block
+            plug::stream_t *tlm = pTelemetry->buffer<plug::stream_t>();
+            bTelemetry          = (tlm != NULL) && (pTelemetryOn->value() >= 0.5f);
+            if (bTelemetry)
+            {
+                for (size_t i=0; i<nChannels; ++i)
+                {
+                    channel_t *c        = &vChannels[i];
+                    c->fTelInPeak       = 0.0f;
+                    c->fTelOutPeak      = 0.0f;
+                    c->fTelGain         = GAIN_AMP_0_DB;
+                    c->bTelAlr          = false;
                 }
+            }
+
+            // The block size is adapted to the oversampling, number of channels and cache size
+            const size_t buf_size   = nBlockSize;
+            const wsize_t cal_start = (bCalibrate) ? profile_time() : 0;
+
+            // Process samples
+            for (size_t nsamples = samples; nsamples > 0; )
+            {
+                // Perform oversampling of signal and sidechain
+                const size_t to_do      = lsp_min(buf_size, nsamples);
+                const size_t to_doxn    = to_do * nOversampling;
+
+                // Pre-mix audio channels
+                for (size_t i=0; i<nChannels; ++i)
+                    premix_channel(i, to_do);
+                if (bProfile)
+                    time            = profile_stage(&vProfile[PS_PREMIX], time);
+
+                // Fully linked channels are processed by one limiter for each link group. The limiters
+                // of other channels do not see the sidechain meanwhile, so after the linking is released
+                // they are fed for the limiter latency while the shared gain is still applied
+                const bool full_link    = (nChannels > 1) && (fStereoLink >= 1.0f) && (fOldStereoLink >= 1.0f);
+                if (full_link)
+                    nLinkWarmup     = limiter_latency();
+                const bool warmup       = (!full_link) && (bLinked) && (nLinkWarmup > 0);
+                bLinked         = (full_link) || (warmup);
+
+                // Do main stuff, channel stages are profiled by channels
+                for (size_t i=0; i<nChannels; ++i)
+                    process_channel_pre(&vChannels[i], to_do);
+                if (bProfile)
+                    time            = profile_time();
+
+                // Perform linking of gain curves
+                if (bLinked)
+                    limit_linked(to_do, warmup);
+                else
+                    link_gains(to_doxn);
+                if (bProfile)
+                    profile_stage(&vProfile[PS_LINK], time);
+
+                // Perform downsampling and post-processing of signal and sidechain
+                for (size_t i=0; i<nChannels; ++i)
+                    process_channel_post(&vChannels[i], to_do);
+                if (bProfile)
+                    time            = profile_time();
+                nBypassFade    -= lsp_min(nBypassFade, to_do);
+
+                // The ramping of gains is complete after the first processed chunk
+                fOldInGain      = fInGain;
+                fOldOutGain     = fOutGain;
+                fOldPreamp      = fPreamp;
+                if (warmup)
+                    nLinkWarmup    -= lsp_min(nLinkWarmup, to_do);
+                else
+                    fOldStereoLink  = fStereoLink;
 
                 // Decrement number of samples for processing
                 nsamples   -= to_do;
             }
 
+            // Measure the processing time of the candidate block size
+            if (bCalibrate)
+            {
+                const wsize_t cal_end   = profile_time();
+                calibrate_block_size(samples, (cal_end > cal_start) ? cal_end - cal_start : 0);
+            }
+
+            // Publish telemetry of the block as a frame of the stream, one value per channel
+            if (bTelemetry)
+            {
+                float v[meta::limiter_metadata::CHANNELS_MAX];
+                const size_t size   = tlm->add_frame(nChannels);
+
+                for (size_t i=0; i<size; ++i)
+                    v[i]                = vChannels[i].fTelInPeak;
+                tlm->write_frame(meta::limiter_metadata::TLM_IN_PEAK, v, 0, size);
+                for (size_t i=0; i<size; ++i)
+                    v[i]                = vChannels[i].fTelOutPeak;
+                tlm->write_frame(meta::limiter_metadata::TLM_OUT_PEAK, v, 0, size);
+                for (size_t i=0; i<size; ++i)
+                    v[i]                = vChannels[i].fTelGain;
+                tlm->write_frame(meta::limiter_metadata::TLM_GAIN, v, 0, size);
+                for (size_t i=0; i<size; ++i)
+                {
+                    const channel_t *c  = &vChannels[i];
+                    const size_t flags  =
+                        ((c->bTelAlr) ? meta::limiter_metadata::TF_ALR : 0) |
+                        ((bBypass) ? meta::limiter_metadata::TF_BYPASS : 0);
+                    v[i]                = float(flags);
+                }
+                tlm->write_frame(meta::limiter_metadata::TLM_FLAGS, v, 0, size);
+
+                // Position and length of the block allow the reader to place the frame on the timeline
+                // and to detect lost frames
+                const float pos_high    = float(nTelPosition / meta::limiter_metadata::TELEMETRY_POS_SPLIT);
+                const float pos_low     = float(nTelPosition % meta::limiter_metadata::TELEMETRY_POS_SPLIT);
+                dsp::fill(v, pos_high, size);
+                tlm->write_frame(meta::limiter_metadata::TLM_POS_HIGH, v, 0, size);
+                dsp::fill(v, pos_low, size);
+                tlm->write_frame(meta::limiter_metadata::TLM_POS_LOW, v, 0, size);
+                dsp::fill(v, float(samples), size);
+                tlm->write_frame(meta::limiter_metadata::TLM_LENGTH, v, 0, size);
+
+                tlm->commit_frame();
+            }
+            nTelPosition       += samples;
+
             // Report gain reduction
             for (size_t i=0; i<nChannels; ++i)
             {
@@ -934,90 +2017,212 @@ namespace lsp
                 c->pMeter[G_GAIN]->set_value(c->sBlink.process(samples));
             }
 
-            // Output history
-            if ((!bPause) || (bClear) || (bUISync))
+            // Move new dots of meter graphs to the multi-resolution history, the number of dots
+            // is counted separately for each graph since graphs are cleared and fed independently
+            if (bMetering)
             {
-                // Process mesh requests
+                size_t produced     = 0;
                 for (size_t i=0; i<nChannels; ++i)
                 {
-                    // Get channel
                     channel_t *c        = &vChannels[i];
-
                     for (size_t j=0; j<G_TOTAL; ++j)
                     {
-                        // Check that port is bound
-                        if (c->pGraph[j] == NULL)
+                        // Meter graphs of hidden graphs are not updated
+                        if (!c->bVisible[j])
                             continue;
 
-                        // Clear data if requested
-                        if (bClear)
-                            c->sGraph[j].clear();
+                        const size_t dots   = (j == G_SC) ?
+                            graph_dots(&c->vHistPhase[j], nHistScPeriod, samples * nScOversampling) :
+                            graph_dots(&c->vHistPhase[j], nHistPeriod, samples * nOversampling);
+                        if (dots <= 0)
+                            continue;
 
-                        // Get mesh
-                        plug::mesh_t *mesh    = c->pGraph[j]->buffer<plug::mesh_t>();
-                        if ((mesh != NULL) && (mesh->isEmpty()))
+                        const size_t count  = lsp_min(dots, meta::limiter_metadata::HISTORY_MESH_SIZE);
+                        c->sGraph[j].read(vHistory, count);
+                        c->sHistory[j].push(vHistory, count);
+                        produced            = lsp_max(produced, count);
+                    }
+                }
+                nHistDots          += produced;
+            }
+
+            // Output history: only new dots are sent, the UI keeps its own copy of the history
+            if ((bMetering) && ((!bPause) || (bClear) || (bUISync)))
+            {
+                // Clear data if requested
+                if (bClear)
+                {
+                    for (size_t i=0; i<nChannels; ++i)
+                    {
+                        channel_t *c        = &vChannels[i];
+                        for (size_t j=0; j<G_TOTAL; ++j)
                         {
-                            // Fill mesh with new values
-                            if (j == G_IN)
-                            {
-                                float *x = mesh->pvData[0];
-                                float *y = mesh->pvData[1];
-
-                                dsp::copy(&x[1], vTime, meta::limiter_metadata::HISTORY_MESH_SIZE);
-                                c->sGraph[j].read(&y[1], meta::limiter_metadata::HISTORY_MESH_SIZE);
-
-                                x[0] = x[1];
-                                y[0] = 0.0f;
-
-                                x[meta::limiter_metadata::HISTORY_MESH_SIZE+1] = x[meta::limiter_metadata::HISTORY_MESH_SIZE];
-                                y[meta::limiter_metadata::HISTORY_MESH_SIZE+1] = 0.0f;
-
-                                mesh->data(2, meta::limiter_metadata::HISTORY_MESH_SIZE + 2);
-                            }
-                            else if (j == G_GAIN)
-                            {
-                                float *x = mesh->pvData[0];
-                                float *y = mesh->pvData[1];
-
-                                dsp::copy(&x[2], vTime, meta::limiter_metadata::HISTORY_MESH_SIZE);
-                                c->sGraph[j].read(&y[2], meta::limiter_metadata::HISTORY_MESH_SIZE);
-
-                                x[0] = x[2] + 0.5f;
-                                x[1] = x[0];
-                                y[0] = 1.0f;
-                                y[1] = y[2];
-
-                                x += meta::limiter_metadata::HISTORY_MESH_SIZE + 2;
-                                y += meta::limiter_metadata::HISTORY_MESH_SIZE + 2;
-                                x[0] = x[-1] - 0.5f;
-                                y[0] = y[-1];
-                                x[1] = x[0];
-                                y[1] = 1.0f;
-
-                                mesh->data(2, meta::limiter_metadata::HISTORY_MESH_SIZE + 4);
-                            }
-                            else
-                            {
-                                dsp::copy(mesh->pvData[0], vTime, meta::limiter_metadata::HISTORY_MESH_SIZE);
-                                c->sGraph[j].read(mesh->pvData[1], meta::limiter_metadata::HISTORY_MESH_SIZE);
-                                mesh->data(2, meta::limiter_metadata::HISTORY_MESH_SIZE);
-                            }
+                            c->sGraph[j].clear();
+                            c->sHistory[j].clear();
+                            c->vHistPhase[j]    = 0;
                         }
-                    } // for j
+                    }
+                    nHistDots           = 0;
+                    nHistSent           = 0;
+                }
+
+                // Send full history on sync, after clear and once per history span to drop accumulated errors
+                const wsize_t total = nHistDots >> nHistLevel;
+                size_t dots         = lsp_min(total - nHistSent, wsize_t(meta::limiter_metadata::HISTORY_MESH_SIZE));
+                nHistSent           = total;
+                nHistKey           += dots;
+                if ((bUISync) || (bClear) || (nHistKey >= meta::limiter_metadata::HISTORY_MESH_SIZE))
+                {
+                    dots                = meta::limiter_metadata::HISTORY_MESH_SIZE;
+                    nHistKey            = 0;
+                }
+
+                for (size_t i=0; (i<nChannels) && (dots > 0); ++i)
+                {
+                    channel_t *c        = &vChannels[i];
+
+                    // Get stream
+                    plug::stream_t *stream  = (c->pHistory != NULL) ? c->pHistory->buffer<plug::stream_t>() : NULL;
+                    if (stream == NULL)
+                        continue;
+
+                    // Emit frame with last dots of each graph at the selected resolution
+                    const size_t count  = stream->add_frame(dots);
+                    for (size_t j=0; j<G_TOTAL; ++j)
+                    {
+                        c->sHistory[j].read(vHistory, count, nHistLevel, j == G_GAIN);
+                        stream->write_frame(j, vHistory, 0, count);
+                    }
+                    stream->commit_frame();
                 }
 
                 // Clear sync flag
-                bUISync = false;
+                bUISync     = false;
             }
 
-            // Request for redraw
-            if (pWrapper != NULL)
-                pWrapper->query_display_draw();
+            // Request for redraw only when new history dots are produced or the state has changed
+            const size_t dot_period = lsp_max(dspu::seconds_to_samples(fSampleRate,
+                meta::limiter_metadata::HISTORY_TIME / meta::limiter_metadata::HISTORY_MESH_SIZE), size_t(1)) << nHistLevel;
+            nIDisplayDots          += samples;
+            if ((nIDisplayDots >= dot_period) || (bIDisplayDirty))
+            {
+                nIDisplayDots          %= dot_period;
+                bIDisplayDirty          = false;
+                if (pWrapper != NULL)
+                    pWrapper->query_display_draw();
+            }
+
+            // Report the CPU load: time spent by process() relative to the duration of the block
+            const wsize_t end   = (bProfile) ? profile_stage(&vProfile[PS_HISTORY], time) : profile_time();
+            const double block  = double(samples) * 1e+9 / fSampleRate;
+            fCpuLoad            = ((block > 0.0) && (end > start)) ? lsp_min(double(end - start) * 100.0 / block, 100.0) : 0.0f;
+            if (bProfile)
+                nProfSamples       += samples;
+            pCpuLoad->set_value(fCpuLoad);
+        }
+
+        void limiter::set_profiling(bool enable)
+        {
+            // Counters of processing stages are accumulated since profiling has been turned on
+            if ((enable) && (!bProfile))
+                reset_profile();
+            bProfile        = enable;
+        }
+
+        wsize_t limiter::profile(size_t stage) const
+        {
+            if (stage >= PS_TOTAL)
+                return 0;
+
+            wsize_t time    = vProfile[stage];
+            for (size_t i=0; i<nChannels; ++i)
+                time           += vChannels[i].vProfile[stage];
+            return time;
+        }
+
+        void limiter::reset_profile()
+        {
+            for (size_t i=0; i<nChannels; ++i)
+            {
+                channel_t *c    = &vChannels[i];
+                for (size_t j=0; j<PS_TOTAL; ++j)
+                    c->vProfile[j]  = 0;
+            }
+            for (size_t i=0; i<PS_TOTAL; ++i)
+                vProfile[i]     = 0;
+            nProfSamples    = 0;
+            fCpuLoad        = 0.0f;
+        }
+
+        void limiter::update_metering(size_t samples)
+        {
+            // Metering is required only if there is UI or the inline display is being drawn
+            const size_t timeout    = dspu::seconds_to_samples(fSampleRate, IDISPLAY_TIMEOUT);
+            nIDisplayIdle           = lsp_min(nIDisplayIdle + samples, timeout);
+
+            const bool metering     = (bUIActive) || (nIDisplayIdle < timeout);
+            if (metering == bMetering)
+                return;
+
+            // History was not updated while metering was off, resync it
+            if (metering)
+            {
+                for (size_t i=0; i<nChannels; ++i)
+                {
+                    channel_t *c    = &vChannels[i];
+                    for (size_t j=0; j<G_TOTAL; ++j)
+                    {
+                        c->sGraph[j].clear();
+                        c->sHistory[j].clear();
+                        c->vHistPhase[j]    = 0;
+                    }
+                }
+                nHistDots       = 0;
+                nHistSent       = 0;
+                bUISync         = true;
+            }
+
+            bMetering       = metering;
         }
 
         void limiter::ui_activated()
         {
-            bUISync = true;
+            bUIActive       = true;
+            bUISync         = true;
+        }
+
+        void limiter::ui_deactivated()
+        {
+            bUIActive       = false;
+        }
+
+        void limiter::update_idisplay_geometry(core::IDBuffer *b, size_t width, size_t height)
+        {
+            idisplay_t *g       = &sIDGeometry;
+
+            // Calc axis params
+            g->fZy              = 1.0f/GAIN_AMP_M_48_DB;
+            g->fDx              = -float(width/meta::limiter_metadata::HISTORY_TIME);
+            g->fDy              = height/(logf(GAIN_AMP_M_48_DB)-logf(GAIN_AMP_0_DB));
+
+            // Vertical lines
+            g->nVLines          = 0;
+            for (float i=1.0; (i < (meta::limiter_metadata::HISTORY_TIME-0.1)) && (g->nVLines < IDISPLAY_LINES_MAX); i += 1.0f)
+                g->vVLines[g->nVLines++]    = width + g->fDx*i;
+
+            // Horizontal lines
+            g->nHLines          = 0;
+            for (float i=GAIN_AMP_M_48_DB; (i<GAIN_AMP_0_DB) && (g->nHLines < IDISPLAY_LINES_MAX); i *= GAIN_AMP_P_24_DB)
+                g->vHLines[g->nHLines++]    = height + g->fDy*(logf(i*g->fZy));
+
+            // Horizontal coordinates of history dots
+            const float r       = meta::limiter_metadata::HISTORY_MESH_SIZE/float(width);
+            for (size_t k=0; k<width; ++k)
+                b->v[0][k]          = width + g->fDx * vTime[size_t(r*k)];
+
+            g->nWidth           = width;
+            g->nHeight          = height;
+            g->pBuffer          = b;
         }
 
         bool limiter::inline_display(plug::ICanvas *cv, size_t width, size_t height)
@@ -1026,60 +2231,50 @@ namespace lsp
             if (height > (M_RGOLD_RATIO * width))
                 height  = M_RGOLD_RATIO * width;
 
+            // Keep metering active while the inline display is shown
+            nIDisplayIdle   = 0;
+
             // Init canvas
             if (!cv->init(width, height))
                 return false;
             width   = cv->width();
             height  = cv->height();
 
+            // Allocate buffer: x, f(x), y
+            pIDisplay           = core::IDBuffer::reuse(pIDisplay, 3, width);
+            core::IDBuffer *b   = pIDisplay;
+            if (b == NULL)
+                return false;
+
+            // Geometry of grid and history dots changes only with the size of the display
+            const idisplay_t *g = &sIDGeometry;
+            if ((g->nWidth != width) || (g->nHeight != height) || (g->pBuffer != b))
+                update_idisplay_geometry(b, width, height);
+
             // Clear background
             bool bypassing = vChannels[0].sBypass.bypassing();
             cv->set_color_rgb((bypassing) ? CV_DISABLED : CV_BACKGROUND);
             cv->paint();
 
-            // Calc axis params
-            float zy    = 1.0f/GAIN_AMP_M_48_DB;
-            float dx    = -float(width/meta::limiter_metadata::HISTORY_TIME);
-            float dy    = height/(logf(GAIN_AMP_M_48_DB)-logf(GAIN_AMP_0_DB));
-
             // Draw axis
             cv->set_line_width(1.0);
 
             // Draw vertical lines
             cv->set_color_rgb(CV_YELLOW, 0.5f);
-            for (float i=1.0; i < (meta::limiter_metadata::HISTORY_TIME-0.1); i += 1.0f)
-            {
-                float ax = width + dx*i;
-                cv->line(ax, 0, ax, height);
-            }
+            for (size_t i=0; i<g->nVLines; ++i)
+                cv->line(g->vVLines[i], 0, g->vVLines[i], height);
 
             // Draw horizontal lines
             cv->set_color_rgb(CV_WHITE, 0.5f);
-            for (float i=GAIN_AMP_M_48_DB; i<GAIN_AMP_0_DB; i *= GAIN_AMP_P_24_DB)
-            {
-                float ay = height + dy*(logf(i*zy));
-                cv->line(0, ay, width, ay);
-            }
-
-            // Allocate buffer: t, f(t), x, y
-            pIDisplay           = core::IDBuffer::reuse(pIDisplay, 4, width);
-            core::IDBuffer *b   = pIDisplay;
-            if (b == NULL)
-                return false;
+            for (size_t i=0; i<g->nHLines; ++i)
+                cv->line(0, g->vHLines[i], width, g->vHLines[i]);
 
             static uint32_t c_colors[] = {
                     CV_MIDDLE_CHANNEL_IN, CV_MIDDLE_CHANNEL, CV_BRIGHT_GREEN, CV_BRIGHT_BLUE,
                     CV_LEFT_CHANNEL_IN, CV_LEFT_CHANNEL, CV_BRIGHT_GREEN, CV_BRIGHT_BLUE,
                     CV_RIGHT_CHANNEL_IN, CV_RIGHT_CHANNEL, CV_BRIGHT_GREEN, CV_BRIGHT_BLUE
                    };
-            uint32_t *cols      = (nChannels > 1) ? &c_colors[G_TOTAL] : c_colors;
-            float r             = meta::limiter_metadata::HISTORY_MESH_SIZE/float(width);
-
-            for (size_t j=0; j<width; ++j)
-            {
-                size_t k        = r*j;
-                b->v[0][j]      = vTime[k];
-            }
+            uint32_t *cols      = (nChannels == 2) ? &c_colors[G_TOTAL] : c_colors;
 
             cv->set_line_width(2.0f);
             for (size_t j=0; j<G_TOTAL; ++j)
@@ -1090,20 +2285,18 @@ namespace lsp
                     if (!c->bVisible[j])
                         continue;
 
-                    // Initialize values
-                    c->sGraph[j].read(vIDisplay, meta::limiter_metadata::HISTORY_MESH_SIZE);
-                    for (size_t k=0; k<width; ++k)
-                        b->v[1][k]      = vIDisplay[size_t(r*k)];
+                    // Initialize values: the deepest gain reduction and the highest level are preserved
+                    c->sHistory[j].read(vIDisplay, meta::limiter_metadata::HISTORY_MESH_SIZE, nHistLevel, j == G_GAIN);
+                    idisplay_decimate(b->v[1], vIDisplay, meta::limiter_metadata::HISTORY_MESH_SIZE, width, j == G_GAIN);
 
                     // Initialize coords
-                    dsp::fill(b->v[2], width, width);
-                    dsp::fill(b->v[3], height, width);
-                    dsp::fmadd_k3(b->v[2], b->v[0], dx, width);
-                    dsp::axis_apply_log1(b->v[3], b->v[1], zy, dy, width);
+                    dsp::fill(b->v[2], height, width);
+                    dsp::axis_apply_log1(b->v[2], b->v[1], g->fZy, g->fDy, width);
 
                     // Draw channel
-                    cv->set_color_rgb((bypassing) ? CV_SILVER : cols[j + i*G_TOTAL]);
-                    cv->draw_lines(b->v[2], b->v[3], width);
+                    const size_t ci = (nChannels == 2) ? i : 0;
+                    cv->set_color_rgb((bypassing) ? CV_SILVER : cols[j + ci*G_TOTAL]);
+                    cv->draw_lines(b->v[0], b->v[2], width);
                 }
             }
 
@@ -1111,7 +2304,7 @@ namespace lsp
             cv->set_color_rgb(CV_MAGENTA, 0.5f);
             cv->set_line_width(1.0);
             {
-                float ay = height + dy*(logf(vChannels[0].sLimit.get_threshold()*zy));
+                float ay = height + g->fDy*(logf(vChannels[0].sLimit.get_threshold()*g->fZy));
                 cv->line(0, ay, width, ay);
             }
 
@@ -1123,7 +2316,10 @@ namespace lsp
             plug::Module::dump(v);
 
             v->write("nChannels", nChannels);
+            v->write("nLinkGroups", nLinkGroups);
             v->write("bSidechain", bSidechain);
+            v->write("bBypass", bBypass);
+            v->write("nBypassFade", nBypassFade);
             v->write("bPause", bPause);
             v->write("bClear", bClear);
             v->write("bScListen", bScListen);
@@ -1145,8 +2341,46 @@ namespace lsp
                         v->write_object(&c->sGraph[j]);
                     v->end_array();
 
+                    v->begin_array("sHistory", c->sHistory, G_TOTAL);
+                    for (size_t j=0; j<G_TOTAL; ++j)
+                        v->write_object(&c->sHistory[j]);
+                    v->end_array();
+
                     v->write_object("sBlink", &c->sBlink);
 
+                    v->begin_array("vIIROver", c->vIIROver, IIR_STAGES_MAX);
+                    for (size_t j=0; j<IIR_STAGES_MAX; ++j)
+                    {
+                        v->begin_object(&c->vIIROver[j], sizeof(iir_stage_t));
+                        {
+                            v->writev("vUp", c->vIIROver[j].vUp, IIR_PATH_MAX * 4);
+                            v->writev("vDown", c->vIIROver[j].vDown, IIR_PATH_MAX * 4);
+                        }
+                        v->end_object();
+                    }
+                    v->end_array();
+
+                    v->begin_array("vIIRScOver", c->vIIRScOver, IIR_STAGES_MAX);
+                    for (size_t j=0; j<IIR_STAGES_MAX; ++j)
+                    {
+                        v->begin_object(&c->vIIRScOver[j], sizeof(iir_stage_t));
+                        {
+                            v->writev("vUp", c->vIIRScOver[j].vUp, IIR_PATH_MAX * 4);
+                            v->writev("vDown", c->vIIRScOver[j].vDown, IIR_PATH_MAX * 4);
+                        }
+                        v->end_object();
+                    }
+                    v->end_array();
+
+                    v->write("fScPeak", c->fScPeak);
+                    v->write("fGainLast", c->fGainLast);
+                    v->write("fTelInPeak", c->fTelInPeak);
+                    v->write("fTelOutPeak", c->fTelOutPeak);
+                    v->writev("vHistPhase", c->vHistPhase, G_TOTAL);
+                    v->write("fTelGain", c->fTelGain);
+                    v->write("bTelAlr", c->bTelAlr);
+                    v->writev("vProfile", c->vProfile, PS_TOTAL);
+
                     v->write("vIn", c->vIn);
                     v->write("vSc", c->vSc);
                     v->write("vShmIn", c->vShmIn);
@@ -1156,11 +2390,13 @@ namespace lsp
                     v->write("vScBuf", c->vScBuf);
                     v->write("vGainBuf", c->vGainBuf);
                     v->write("vOutBuf", c->vOutBuf);
+                    v->write("vLimitSc", c->vLimitSc);
 
                     v->writev("bVisible", c->bVisible, G_TOTAL);
                     v->write("bOutVisible", c->bOutVisible);
                     v->write("bGainVisible", c->bGainVisible);
                     v->write("bScVisible", c->bScVisible);
+                    v->write("nLinkGroup", c->nLinkGroup);
 
                     v->write("pIn", c->pIn);
                     v->write("pOut", c->pOut);
@@ -1168,7 +2404,7 @@ namespace lsp
                     v->write("pShmIn", c->pShmIn);
                     v->writev("pVisible", c->pVisible, G_TOTAL);
 
-                    v->writev("pGraph", c->pGraph, G_TOTAL);
+                    v->write("pHistory", c->pHistory);
                     v->writev("pMeter", c->pMeter, G_TOTAL);
                 }
                 v->end_object();
@@ -1177,13 +2413,66 @@ namespace lsp
 
             v->write("vTime", vTime);
             v->write("vIDisplay", vIDisplay);
+            v->write("vHistory", vHistory);
+            v->write("nHistPeriod", nHistPeriod);
+            v->write("nHistScPeriod", nHistScPeriod);
+            v->write("nHistDots", nHistDots);
+            v->write("nHistSent", nHistSent);
+            v->write("nHistKey", nHistKey);
+            v->write("nHistLevel", nHistLevel);
+            v->write("nOversampling", nOversampling);
+            v->write("nScOversampling", nScOversampling);
+            v->write("nIIRStages", nIIRStages);
+            v->write("bGainDecim", bGainDecim);
+            v->write("bLinked", bLinked);
+            v->write("nLinkWarmup", nLinkWarmup);
             v->write("nScMode", nScMode);
             v->write("fInGain", fInGain);
             v->write("fOutGain", fOutGain);
             v->write("fPreamp", fPreamp);
             v->write("fStereoLink", fStereoLink);
+            v->write("fOldInGain", fOldInGain);
+            v->write("fOldOutGain", fOldOutGain);
+            v->write("fOldPreamp", fOldPreamp);
+            v->write("fOldStereoLink", fOldStereoLink);
+            v->write("fThresh", fThresh);
+            v->writev("vParams", vParams, P_TOTAL);
+            v->write("bReconfigure", bReconfigure);
+            v->write("bReady", bReady);
             v->write("pIDisplay", pIDisplay);
             v->write("bUISync", bUISync);
+            v->write("bUIActive", bUIActive);
+            v->write("bMetering", bMetering);
+            v->write("bTelemetry", bTelemetry);
+            v->write("nTelPosition", nTelPosition);
+            v->write("bProfile", bProfile);
+            v->writev("vProfile", vProfile, PS_TOTAL);
+            v->write("nProfSamples", nProfSamples);
+            v->write("fCpuLoad", fCpuLoad);
+            v->write("nCacheSize", nCacheSize);
+            v->write("nBlockSize", nBlockSize);
+            v->write("bCalibrate", bCalibrate);
+            v->write("nCalibSamples", nCalibSamples);
+            v->write("nCalibTime", nCalibTime);
+            v->write("nCalibBest", nCalibBest);
+            v->write("fCalibCost", fCalibCost);
+            v->write("nIDisplayIdle", nIDisplayIdle);
+            v->write("nIDisplayDots", nIDisplayDots);
+            v->write("bIDisplayDirty", bIDisplayDirty);
+            v->begin_object("sIDGeometry", &sIDGeometry, sizeof(idisplay_t));
+            {
+                v->write("nWidth", sIDGeometry.nWidth);
+                v->write("nHeight", sIDGeometry.nHeight);
+                v->write("fZy", sIDGeometry.fZy);
+                v->write("fDx", sIDGeometry.fDx);
+                v->write("fDy", sIDGeometry.fDy);
+                v->writev("vVLines", sIDGeometry.vVLines, IDISPLAY_LINES_MAX);
+                v->writev("vHLines", sIDGeometry.vHLines, IDISPLAY_LINES_MAX);
+                v->write("nVLines", sIDGeometry.nVLines);
+                v->write("nHLines", sIDGeometry.nHLines);
+                v->write("pBuffer", sIDGeometry.pBuffer);
+            }
+            v->end_object();
 
             v->write_object("sDither", &sDither);
             v->begin_object("sPremix", &sPremix, sizeof(premix_t));
@@ -1195,13 +2484,13 @@ namespace lsp
                 v->write("fScToIn", sPremix.fScToIn);
                 v->write("fScToLink", sPremix.fScToLink);
 
-                v->writev("vIn", sPremix.vIn, 2);
-                v->writev("vOut", sPremix.vOut, 2);
-                v->writev("vSc", sPremix.vSc, 2);
-                v->writev("vLink", sPremix.vLink, 2);
-                v->writev("vTmpIn", sPremix.vTmpIn, 2);
-                v->writev("vTmpLink", sPremix.vTmpLink, 2);
-                v->writev("vTmpSc", sPremix.vTmpSc, 2);
+                v->writev("vIn", sPremix.vIn, nChannels);
+                v->writev("vOut", sPremix.vOut, nChannels);
+                v->writev("vSc", sPremix.vSc, nChannels);
+                v->writev("vLink", sPremix.vLink, nChannels);
+                v->writev("vTmpIn", sPremix.vTmpIn, nChannels);
+                v->writev("vTmpLink", sPremix.vTmpLink, nChannels);
+                v->writev("vTmpSc", sPremix.vTmpSc, nChannels);
 
                 v->write("pInToSc", sPremix.pInToSc);
                 v->write("pInToLink", sPremix.pInToLink);
@@ -1234,6 +2523,12 @@ namespace lsp
             v->write("pOversampling", pOversampling);
             v->write("pDithering", pDithering);
             v->write("pStereoLink", pStereoLink);
+            v->write("pLfeLink", pLfeLink);
+            v->write("pGainDecim", pGainDecim);
+            v->write("pHistSpan", pHistSpan);
+            v->write("pTelemetryOn", pTelemetryOn);
+            v->write("pTelemetry", pTelemetry);
+            v->write("pCpuLoad", pCpuLoad);
             v->write("pData", pData);
         }
     } /* namespace plugins */
@@ -19,8 +19,14 @@
  * along with lsp-plugins-limiter. If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <lsp-plug.in/common/alloc.h>
+#include <lsp-plug.in/dsp/dsp.h>
+#include <lsp-plug.in/dsp-units/units.h>
+#include <lsp-plug.in/stdlib/stdio.h>
+#include <lsp-plug.in/stdlib/string.h>
+
 #include <private/plugins/limiter.h>
-#include <lsp-plug.in/plug-fw/ui.h>
+#include <private/ui/limiter.h>
 
 namespace lsp
 {
@@ -33,12 +39,235 @@ namespace lsp
             &meta::limiter_mono,
             &meta::limiter_stereo,
             &meta::sc_limiter_mono,
-            &meta::sc_limiter_stereo
+            &meta::sc_limiter_stereo,
+            &meta::limiter_5_1,
+            &meta::limiter_7_1,
+            &meta::limiter_7_1_4
+        };
+
+        static ui::Module *ui_factory(const meta::plugin_t *meta)
+        {
+            return new limiter_ui(meta);
+        }
+
+        static ui::Factory factory(ui_factory, plugin_uis, 7);
+
+        static const char *graph_prefixes[] =
+        {
+            "ig",
+            "og",
+            "scg",
+            "grg"
         };
 
-        static ui::Factory factory(plugin_uis, 4);
+        //---------------------------------------------------------------------
+        limiter_ui::limiter_ui(const meta::plugin_t *meta): ui::Module(meta)
+        {
+            nChannels       = 0;
+            vTime           = NULL;
+            vX              = NULL;
+            vY              = NULL;
+            pData           = NULL;
+        }
+
+        limiter_ui::~limiter_ui()
+        {
+            destroy();
+        }
+
+        status_t limiter_ui::post_init()
+        {
+            status_t res = ui::Module::post_init();
+            if (res != STATUS_OK)
+                return res;
+
+            // Count history streams
+            nChannels       = 0;
+            for (const meta::port_t *p = pMetadata->ports; p->id != NULL; ++p)
+            {
+                if ((p->role == meta::R_STREAM) && (!strncmp(p->id, "hs", 2)))
+                    ++nChannels;
+            }
+            nChannels       = lsp_min(nChannels, meta::limiter_metadata::CHANNELS_MAX);
+            if (nChannels <= 0)
+                return STATUS_OK;
+
+            // Allocate buffers
+            const size_t h_data     = meta::limiter_metadata::HISTORY_MESH_SIZE * sizeof(float);
+            const size_t m_data     = (meta::limiter_metadata::HISTORY_MESH_SIZE + 4) * sizeof(float);
+            const size_t allocate   =
+                h_data +                            // vTime
+                m_data * 2 +                        // vX, vY
+                h_data * G_TOTAL * nChannels;       // vHistory
+
+            uint8_t *ptr    = alloc_aligned<uint8_t>(pData, allocate, DEFAULT_ALIGN);
+            if (ptr == NULL)
+                return STATUS_NO_MEM;
+
+            vTime           = advance_ptr_bytes<float>(ptr, h_data);
+            vX              = advance_ptr_bytes<float>(ptr, m_data);
+            vY              = advance_ptr_bytes<float>(ptr, m_data);
+
+            const float delta   = meta::limiter_metadata::HISTORY_TIME / (meta::limiter_metadata::HISTORY_MESH_SIZE - 1);
+            for (size_t i=0; i<meta::limiter_metadata::HISTORY_MESH_SIZE; ++i)
+                vTime[i]        = meta::limiter_metadata::HISTORY_TIME - i*delta;
+
+            // Bind channels to streams and meshes
+            char id[32];
+            size_t index    = 0;
+            for (const meta::port_t *p = pMetadata->ports; (p->id != NULL) && (index < nChannels); ++p)
+            {
+                if ((p->role != meta::R_STREAM) || (strncmp(p->id, "hs", 2)))
+                    continue;
+
+                channel_t *c    = &vChannels[index++];
+                const char *suffix  = &p->id[2];
+
+                c->pStream      = pWrapper->port(p->id);
+                c->nFrameId     = 0;
+                for (size_t j=0; j<G_TOTAL; ++j)
+                {
+                    c->vHistory[j]  = advance_ptr_bytes<float>(ptr, h_data);
+                    dsp::fill(c->vHistory[j], (j == G_GAIN) ? GAIN_AMP_0_DB : GAIN_AMP_M_INF_DB, meta::limiter_metadata::HISTORY_MESH_SIZE);
+
+                    snprintf(id, sizeof(id), "%s%s", graph_prefixes[j], suffix);
+                    c->wGraph[j]    = pWrapper->controller()->widgets()->get<tk::GraphMesh>(id);
+                }
+
+                if (c->pStream != NULL)
+                {
+                    plug::stream_t *stream  = c->pStream->buffer<plug::stream_t>();
+                    if (stream != NULL)
+                        c->nFrameId             = stream->frame_id();
+                    c->pStream->bind(this);
+                }
+            }
+
+            return STATUS_OK;
+        }
+
+        void limiter_ui::destroy()
+        {
+            for (size_t i=0; i<nChannels; ++i)
+            {
+                channel_t *c    = &vChannels[i];
+                if (c->pStream != NULL)
+                {
+                    c->pStream->unbind(this);
+                    c->pStream      = NULL;
+                }
+            }
+            nChannels       = 0;
+
+            if (pData != NULL)
+            {
+                free_aligned(pData);
+                pData           = NULL;
+            }
+            vTime           = NULL;
+            vX              = NULL;
+            vY              = NULL;
+
+            ui::Module::destroy();
+        }
+
+        bool limiter_ui::consume_frames(channel_t *c)
+        {
+            plug::stream_t *stream  = c->pStream->buffer<plug::stream_t>();
+            if (stream == NULL)
+                return false;
+
+            // Frames that were overwritten in the stream are lost, the next full history will restore them
+            const uint32_t last     = stream->frame_id();
+            uint32_t frame_id       = c->nFrameId + 1;
+            if ((last - c->nFrameId) > stream->frames())
+                frame_id                = last - stream->frames() + 1;
+
+            bool updated            = false;
+            for ( ; frame_id != (last + 1); ++frame_id)
+            {
+                const ssize_t size      = stream->get_frame_size(frame_id);
+                if (size <= 0)
+                    continue;
+
+                // Shift history and append new dots
+                const size_t count      = lsp_min(size_t(size), meta::limiter_metadata::HISTORY_MESH_SIZE);
+                const size_t keep       = meta::limiter_metadata::HISTORY_MESH_SIZE - count;
+                for (size_t j=0; j<G_TOTAL; ++j)
+                {
+                    float *h                = c->vHistory[j];
+                    dsp::move(h, &h[count], keep);
+                    stream->read_frame(frame_id, j, &h[keep], size - count, count);
+                }
+                updated                 = true;
+            }
+            c->nFrameId             = last;
+
+            return updated;
+        }
+
+        void limiter_ui::sync_mesh(channel_t *c, size_t graph)
+        {
+            tk::GraphMesh *mesh     = c->wGraph[graph];
+            if (mesh == NULL)
+                return;
+
+            const size_t n          = meta::limiter_metadata::HISTORY_MESH_SIZE;
+            const float *h          = c->vHistory[graph];
+            float *x                = vX;
+            float *y                = vY;
+
+            if (graph == G_IN)
+            {
+                // Closed curve for filling
+                dsp::copy(&x[1], vTime, n);
+                dsp::copy(&y[1], h, n);
+
+                x[0]    = x[1];
+                y[0]    = 0.0f;
+                x[n+1]  = x[n];
+                y[n+1]  = 0.0f;
+
+                mesh->data()->set(x, y, n + 2);
+            }
+            else if (graph == G_GAIN)
+            {
+                // Closed curve for filling from the top of the graph
+                dsp::copy(&x[2], vTime, n);
+                dsp::copy(&y[2], h, n);
+
+                x[0]    = x[2] + 0.5f;
+                x[1]    = x[0];
+                y[0]    = 1.0f;
+                y[1]    = y[2];
+
+                x[n+2]  = x[n+1] - 0.5f;
+                y[n+2]  = y[n+1];
+                x[n+3]  = x[n+2];
+                y[n+3]  = 1.0f;
+
+                mesh->data()->set(x, y, n + 4);
+            }
+            else
+                mesh->data()->set(vTime, h, n);
+        }
+
+        void limiter_ui::notify(ui::IPort *port, size_t flags)
+        {
+            for (size_t i=0; i<nChannels; ++i)
+            {
+                channel_t *c    = &vChannels[i];
+                if (c->pStream != port)
+                    continue;
 
-    } // namespace plugui
-} // namespace lsp
+                if (!consume_frames(c))
+                    return;
 
+                for (size_t j=0; j<G_TOTAL; ++j)
+                    sync_mesh(c, j);
+                return;
+            }
+        }
 
+    } /* namespace plugui */
+} /* namespace lsp */
@@ -0,0 +1,366 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-limiter
+ * Created on: 17 окт. 2026 г.
+ *
+ * lsp-plugins-limiter is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-limiter is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-limiter. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/common/alloc.h>
+#include <lsp-plug.in/dsp/dsp.h>
+#include <lsp-plug.in/dsp-units/units.h>
+#include <lsp-plug.in/stdlib/locale.h>
+#include <lsp-plug.in/stdlib/stdio.h>
+#include <lsp-plug.in/stdlib/stdlib.h>
+#include <lsp-plug.in/stdlib/string.h>
+
+#include <private/test/host.h>
+
+#include <ctype.h>
+#include <errno.h>
+
+namespace lsp
+{
+    namespace test
+    {
+        static constexpr size_t PRESET_LINE_MAX     = 1024;
+
+        static bool starts_with(const char *s, const char *prefix)
+        {
+            for ( ; *prefix != '\0'; ++s, ++prefix)
+            {
+                if (tolower(*s) != tolower(*prefix))
+                    return false;
+            }
+            return true;
+        }
+
+        //---------------------------------------------------------------------
+        HostPort::HostPort(const meta::port_t *meta): plug::IPort(meta)
+        {
+            // The bypass port is inverted by wrappers: 'enabled' means 'not bypassed'
+            fValue      = (meta->role == meta::R_BYPASS) ? 0.0f : meta->start;
+            pBuffer     = NULL;
+            pStream     = (meta->role == meta::R_STREAM) ?
+                plug::stream_t::create(meta->min, meta->max, meta->start) : NULL;
+        }
+
+        HostPort::~HostPort()
+        {
+            pBuffer     = NULL;
+            if (pStream != NULL)
+            {
+                plug::stream_t::destroy(pStream);
+                pStream     = NULL;
+            }
+        }
+
+        float HostPort::value()
+        {
+            return fValue;
+        }
+
+        void HostPort::set_value(float value)
+        {
+            fValue      = value;
+        }
+
+        void *HostPort::buffer()
+        {
+            return (pStream != NULL) ? static_cast<void *>(pStream) : pBuffer;
+        }
+
+        void HostPort::bind(float *buf)
+        {
+            pBuffer     = buf;
+        }
+
+        //---------------------------------------------------------------------
+        PluginHost::PluginHost()
+        {
+            pMetadata   = NULL;
+            pModule     = NULL;
+            vPorts      = NULL;
+            nPorts      = 0;
+            vIn         = NULL;
+            vOut        = NULL;
+            nIn         = 0;
+            nOut        = 0;
+            nBlockSize  = 0;
+            nSampleRate = 0;
+            nPosition   = 0;
+            pData       = NULL;
+        }
+
+        PluginHost::~PluginHost()
+        {
+            destroy();
+        }
+
+        plug::Module *PluginHost::create_module(const meta::plugin_t *meta)
+        {
+            for (plug::Factory *f = plug::Factory::root(); f != NULL; f = f->next())
+            {
+                for (size_t i=0; ; ++i)
+                {
+                    const meta::plugin_t *m = f->enumerate(i);
+                    if (m == NULL)
+                        break;
+                    if (m == meta)
+                        return f->create(m);
+                }
+            }
+
+            return NULL;
+        }
+
+        status_t PluginHost::init(const meta::plugin_t *meta, size_t sample_rate, size_t block_size)
+        {
+            destroy();
+
+            // Count ports and audio channels
+            for (const meta::port_t *p = meta->ports; p->id != NULL; ++p)
+            {
+                ++nPorts;
+                if (p->role == meta::R_AUDIO_IN)
+                    ++nIn;
+                else if (p->role == meta::R_AUDIO_OUT)
+                    ++nOut;
+            }
+
+            // Allocate audio buffers
+            const size_t audio  = nIn + nOut;
+            const size_t to_alloc   =
+                block_size * audio * sizeof(float) +
+                audio * sizeof(float *);
+            uint8_t *ptr        = alloc_aligned<uint8_t>(pData, to_alloc, DEFAULT_ALIGN);
+            if (ptr == NULL)
+                return STATUS_NO_MEM;
+
+            float *buf          = advance_ptr_bytes<float>(ptr, block_size * audio * sizeof(float));
+            vIn                 = advance_ptr_bytes<float *>(ptr, nIn * sizeof(float *));
+            vOut                = advance_ptr_bytes<float *>(ptr, nOut * sizeof(float *));
+            dsp::fill_zero(buf, block_size * audio);
+            nBlockSize          = block_size;
+
+            // Create ports
+            vPorts              = new HostPort *[nPorts];
+            if (vPorts == NULL)
+                return STATUS_NO_MEM;
+            for (size_t i=0; i<nPorts; ++i)
+                vPorts[i]           = NULL;
+
+            size_t in = 0, out = 0;
+            for (size_t i=0; i<nPorts; ++i)
+            {
+                const meta::port_t *p = &meta->ports[i];
+                HostPort *port      = new HostPort(p);
+                if (port == NULL)
+                    return STATUS_NO_MEM;
+                vPorts[i]           = port;
+
+                if (p->role == meta::R_AUDIO_IN)
+                    vIn[in++]           = buf;
+                else if (p->role == meta::R_AUDIO_OUT)
+                    vOut[out++]         = buf;
+                else
+                    continue;
+
+                port->bind(buf);
+                buf                += block_size;
+            }
+
+            // Create and initialize the module
+            pModule             = create_module(meta);
+            if (pModule == NULL)
+                return STATUS_NOT_FOUND;
+            pMetadata           = meta;
+            nSampleRate         = sample_rate;
+            nPosition           = 0;
+
+            pModule->init(NULL, reinterpret_cast<plug::IPort **>(vPorts));
+            pModule->set_sample_rate(sample_rate);
+            pModule->update_settings();
+
+            return STATUS_OK;
+        }
+
+        void PluginHost::destroy()
+        {
+            if (pModule != NULL)
+            {
+                pModule->destroy();
+                delete pModule;
+                pModule     = NULL;
+            }
+            if (vPorts != NULL)
+            {
+                for (size_t i=0; i<nPorts; ++i)
+                    if (vPorts[i] != NULL)
+                        delete vPorts[i];
+                delete [] vPorts;
+                vPorts      = NULL;
+            }
+            free_aligned(pData);
+            pData       = NULL;
+
+            pMetadata   = NULL;
+            nPorts      = 0;
+            vIn         = NULL;
+            vOut        = NULL;
+            nIn         = 0;
+            nOut        = 0;
+            nBlockSize  = 0;
+            nSampleRate = 0;
+            nPosition   = 0;
+        }
+
+        HostPort *PluginHost::port(const char *id)
+        {
+            for (size_t i=0; i<nPorts; ++i)
+            {
+                const meta::port_t *p = vPorts[i]->metadata();
+                if ((p != NULL) && (!strcmp(p->id, id)))
+                    return vPorts[i];
+            }
+            return NULL;
+        }
+
+        status_t PluginHost::set_value(const char *id, float value)
+        {
+            HostPort *p     = port(id);
+            if (p == NULL)
+                return STATUS_NOT_FOUND;
+
+            const meta::port_t *meta = p->metadata();
+            if (meta->role == meta::R_BYPASS)
+                value           = (value >= 0.5f) ? 0.0f : 1.0f;
+            p->set_value(value);
+
+            return STATUS_OK;
+        }
+
+        status_t PluginHost::set_param(const char *param)
+        {
+            char id[PRESET_LINE_MAX];
+
+            // Parse identifier
+            const char *eq  = strchr(param, '=');
+            if (eq == NULL)
+                return STATUS_BAD_FORMAT;
+
+            const char *end = eq;
+            while ((end > param) && (isspace(end[-1])))
+                --end;
+            while ((param < end) && (isspace(*param)))
+                ++param;
+            const size_t len = end - param;
+            if ((len == 0) || (len >= PRESET_LINE_MAX))
+                return STATUS_BAD_FORMAT;
+            memcpy(id, param, len);
+            id[len]         = '\0';
+
+            HostPort *p     = port(id);
+            if (p == NULL)
+                return STATUS_NOT_FOUND;
+
+            // Parse value
+            const char *v   = eq + 1;
+            while (isspace(*v))
+                ++v;
+
+            float value;
+            if (starts_with(v, "true"))
+                value           = 1.0f;
+            else if (starts_with(v, "false"))
+                value           = 0.0f;
+            else
+            {
+                SET_LOCALE_SCOPED(LC_NUMERIC, "C");
+                char *vend      = NULL;
+                errno           = 0;
+                value           = strtof(v, &vend);
+                if ((errno != 0) || (vend == v))
+                    return STATUS_BAD_FORMAT;
+
+                // Gain values may be specified in decibels
+                while (isspace(*vend))
+                    ++vend;
+                if (starts_with(vend, "db"))
+                {
+                    const meta::port_t *meta = p->metadata();
+                    if (meta->unit == meta::U_GAIN_AMP)
+                        value           = dspu::db_to_gain(value);
+                    else if (meta->unit == meta::U_GAIN_POW)
+                        value           = dspu::db_to_power(value);
+                }
+            }
+
+            return set_value(id, value);
+        }
+
+        status_t PluginHost::load_preset(const char *path)
+        {
+            char line[PRESET_LINE_MAX];
+
+            FILE *fd        = fopen(path, "r");
+            if (fd == NULL)
+                return STATUS_NOT_FOUND;
+
+            while (fgets(line, sizeof(line), fd) != NULL)
+            {
+                // Skip empty lines and comments
+                const char *s   = line;
+                while (isspace(*s))
+                    ++s;
+                if ((*s == '\0') || (*s == '#'))
+                    continue;
+
+                // Ports not known to the plugin are not an error: presets may contain
+                // UI-only parameters or parameters of other plugin variants
+                const status_t res = set_param(s);
+                if ((res != STATUS_OK) && (res != STATUS_NOT_FOUND))
+                {
+                    fclose(fd);
+                    return res;
+                }
+            }
+
+            fclose(fd);
+            return STATUS_OK;
+        }
+
+        void PluginHost::update_settings()
+        {
+            if (pModule != NULL)
+                pModule->update_settings();
+        }
+
+        void PluginHost::process(size_t samples)
+        {
+            samples         = lsp_min(samples, nBlockSize);
+            pModule->process(samples);
+            nPosition      += samples;
+        }
+
+        size_t PluginHost::latency() const
+        {
+            const ssize_t latency = (pModule != NULL) ? pModule->latency() : 0;
+            return (latency > 0) ? latency : 0;
+        }
+
+    } /* namespace test */
+} /* namespace lsp */
@@ -0,0 +1,968 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-limiter
+ * Created on: 17 окт. 2026 г.
+ *
+ * lsp-plugins-limiter is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-limiter is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-limiter. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/common/alloc.h>
+#include <lsp-plug.in/common/finally.h>
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/dsp/dsp.h>
+#include <lsp-plug.in/dsp-units/units.h>
+#include <lsp-plug.in/dsp-units/util/Randomizer.h>
+#include <lsp-plug.in/ipc/Mutex.h>
+#include <lsp-plug.in/ipc/Thread.h>
+#include <lsp-plug.in/mm/InAudioFileStream.h>
+#include <lsp-plug.in/mm/OutAudioFileStream.h>
+#include <lsp-plug.in/stdlib/stdio.h>
+#include <lsp-plug.in/stdlib/stdlib.h>
+#include <lsp-plug.in/stdlib/string.h>
+#include <lsp-plug.in/test-fw/mtest.h>
+
+#include <private/meta/limiter.h>
+#include <private/test/host.h>
+
+#include <math.h>
+
+/**
+ * Headless batch renderer: streams audio files through the limiter module without UI.
+ *
+ * Usage:
+ *   mtest limiter.batch [-p preset] [-s id=value]... [-o directory] [-j threads] [-b block]
+ *                       [-c seconds [-r seconds] [-S seed] [-v tolerance]] [-T suffix] file...
+ *
+ *   -p preset      load port values from the preset file
+ *   -s id=value    set value of the port, applied after the preset
+ *   -o directory   directory to store output files as '<directory>/<name>.wav', by default '<file>.limited.wav' is written
+ *   -j threads     number of files processed concurrently, by default the number of CPU cores
+ *   -b block       number of frames passed to process() at once
+ *   -c seconds     split each file into chunks of the specified length and render chunks concurrently
+ *   -r seconds     pre-roll rendered before each chunk to warm up the limiter state, 5 seconds by default
+ *   -S seed        dither seed of the first chunk, each next chunk uses the next seed
+ *   -v tolerance   render the file serially and fail if the difference exceeds the tolerance in dB
+ *   -T suffix      write per-block telemetry of the plugin to '<output><suffix>' CSV file
+ *
+ * The plugin variant is selected by the number of channels in the file. The output is aligned
+ * with the input: the latency of the limiter is compensated.
+ *
+ * In chunk mode files are processed one by one. Chunks are rendered with dithering disabled in
+ * the plugin and stitched sample-exactly, the triangular dither with the same bit depth is then
+ * applied by the renderer with a deterministic seed, so the result does not depend on the number
+ * of threads.
+ *
+ * Telemetry is collected in serial mode only. The 'tlm' port of the plugin is turned on and new
+ * frames of the 'tlms' stream are read after each processed block, the same way as the host reads
+ * the stream while the plugin is running. Each row holds the position and the length of the block
+ * reported by the plugin, and the number of frames that were overwritten before they were read.
+ */
+namespace
+{
+    using namespace lsp;
+
+    static constexpr size_t BATCH_BLOCK_SIZE    = 0x4000;
+    static constexpr size_t BATCH_PATH_MAX      = 4096;
+    static constexpr float BATCH_PREROLL        = 5.0f;
+    static constexpr float BATCH_TOLERANCE      = -96.0f;
+
+    typedef struct batch_t
+    {
+        const char        **vFiles;         // List of files to process
+        size_t              nFiles;         // Number of files
+        const char         *sPreset;        // Preset file
+        const char        **vParams;        // List of port values in 'id=value' form
+        size_t              nParams;        // Number of port values
+        const char         *sOutDir;        // Output directory
+        size_t              nBlockSize;     // Processing block size
+        float               fChunk;         // Length of chunk in seconds, 0 disables chunk-parallel rendering
+        float               fPreroll;       // Pre-roll of each chunk in seconds
+        uint32_t            nSeed;          // Dither seed of the first chunk
+        bool                bVerify;        // Compare chunk-parallel rendering with serial rendering
+        float               fTolerance;     // Maximum allowed difference from serial rendering in dB
+        const char         *sTelemetry;     // Suffix of the telemetry file, NULL disables telemetry
+        ipc::Mutex          sLock;          // Lock for the fields below
+        size_t              nNext;          // Index of the next file to process
+        size_t              nFailed;        // Number of failed files
+    } batch_t;
+
+    static const meta::plugin_t *select_plugin(size_t channels)
+    {
+        switch (channels)
+        {
+            case 1:     return &meta::limiter_mono;
+            case 2:     return &meta::limiter_stereo;
+            case 6:     return &meta::limiter_5_1;
+            case 8:     return &meta::limiter_7_1;
+            case 12:    return &meta::limiter_7_1_4;
+            default:    break;
+        }
+        return NULL;
+    }
+
+    /**
+     * Make the path of the output file. The output is always written in WAV format, so the
+     * extension of the source file is replaced by '.wav'
+     * @param dst buffer to store the path
+     * @param len size of the buffer
+     * @param src path to the source file
+     * @param dir output directory, NULL if the output is stored next to the source file
+     */
+    static void make_output_path(char *dst, size_t len, const char *src, const char *dir)
+    {
+        const char *name    = strrchr(src, FILE_SEPARATOR_C);
+        name                = (name != NULL) ? name + 1 : src;
+        const char *ext     = strrchr(name, '.');
+
+        if (dir != NULL)
+        {
+            const int prefix    = (ext != NULL) ? int(ext - name) : int(strlen(name));
+            snprintf(dst, len, "%s%c%.*s.wav", dir, FILE_SEPARATOR_C, prefix, name);
+            return;
+        }
+
+        // Replace the extension of the source file
+        const int prefix    = (ext != NULL) ? int(ext - src) : int(strlen(src));
+        snprintf(dst, len, "%.*s.limited.wav", prefix, src);
+    }
+
+    static size_t dither_bits(size_t mode)
+    {
+        switch (mode)
+        {
+            case meta::limiter_metadata::DITHER_7BIT:   return 7;
+            case meta::limiter_metadata::DITHER_8BIT:   return 8;
+            case meta::limiter_metadata::DITHER_11BIT:  return 11;
+            case meta::limiter_metadata::DITHER_12BIT:  return 12;
+            case meta::limiter_metadata::DITHER_15BIT:  return 15;
+            case meta::limiter_metadata::DITHER_16BIT:  return 16;
+            case meta::limiter_metadata::DITHER_23BIT:  return 23;
+            case meta::limiter_metadata::DITHER_24BIT:  return 24;
+            default: break;
+        }
+        return 0;
+    }
+
+    /**
+     * Apply triangular dither with deterministic seed
+     */
+    static void apply_dither(float *dst, size_t count, size_t bits, uint32_t seed)
+    {
+        if (bits <= 0)
+            return;
+
+        dspu::Randomizer rnd;
+        rnd.init(seed);
+
+        const float lsb     = 1.0f / float(1 << (bits - 1));
+        for (size_t i=0; i<count; ++i)
+            dst[i]             += (rnd.random(dspu::RND_LINEAR) - rnd.random(dspu::RND_LINEAR)) * lsb;
+    }
+
+    static status_t apply_settings(test::PluginHost *host, const batch_t *batch)
+    {
+        status_t res;
+        if ((batch->sPreset != NULL) && ((res = host->load_preset(batch->sPreset)) != STATUS_OK))
+            return res;
+        for (size_t i=0; i<batch->nParams; ++i)
+        {
+            if ((res = host->set_param(batch->vParams[i])) != STATUS_OK)
+                return res;
+        }
+        host->update_settings();
+
+        return STATUS_OK;
+    }
+
+    /**
+     * Streaming renderer: reads the file and produces the output of the plugin aligned
+     * with the input, the latency of the plugin is compensated
+     */
+    typedef struct renderer_t
+    {
+        mm::InAudioFileStream   sIn;            // Input stream
+        mm::audio_stream_t      sFormat;        // Format of the input stream
+        test::PluginHost        sHost;          // Plugin host
+        size_t                  nSkip;          // Number of output frames to drop
+        size_t                  nTail;          // Number of frames to process after the end of file
+        bool                    bEof;           // End of file reached
+        FILE                   *pTelemetry;     // Telemetry output file
+        uint32_t                nTelFrame;      // Identifier of the last read frame of the telemetry stream
+        wsize_t                 nTelDropped;    // Number of telemetry frames lost before they were read
+        float                  *vBuf;           // Buffer for interleaved input data
+        uint8_t                *pData;          // Allocated data
+    } renderer_t;
+
+    static void init_renderer(renderer_t *r)
+    {
+        r->nSkip            = 0;
+        r->nTail            = 0;
+        r->bEof             = false;
+        r->pTelemetry       = NULL;
+        r->nTelFrame        = 0;
+        r->nTelDropped      = 0;
+        r->vBuf             = NULL;
+        r->pData            = NULL;
+    }
+
+    /**
+     * Open the renderer
+     * @param r renderer
+     * @param batch batch settings
+     * @param src source file
+     * @param offset the first frame of the file to read
+     * @param skip number of output frames to drop in addition to latency
+     * @param dither allow the plugin to perform dithering
+     * @return status of operation
+     */
+    static status_t open_renderer(renderer_t *r, const batch_t *batch, const char *src, wsize_t offset, size_t skip, bool dither)
+    {
+        status_t res;
+
+        init_renderer(r);
+        if ((res = r->sIn.open(src)) != STATUS_OK)
+            return res;
+        if ((res = r->sIn.info(&r->sFormat)) != STATUS_OK)
+            return res;
+        if ((offset > 0) && (r->sIn.skip(offset) != wssize_t(offset)))
+            return STATUS_IO_ERROR;
+
+        const meta::plugin_t *meta  = select_plugin(r->sFormat.channels);
+        if (meta == NULL)
+            return STATUS_UNSUPPORTED_FORMAT;
+
+        const size_t block          = batch->nBlockSize;
+        if ((res = r->sHost.init(meta, r->sFormat.srate, block)) != STATUS_OK)
+            return res;
+        if ((res = apply_settings(&r->sHost, batch)) != STATUS_OK)
+            return res;
+        if (!dither)
+        {
+            r->sHost.set_value("dith", meta::limiter_metadata::DITHER_NONE);
+            r->sHost.update_settings();
+        }
+
+        r->vBuf             = alloc_aligned<float>(r->pData, block * r->sFormat.channels, DEFAULT_ALIGN);
+        if (r->vBuf == NULL)
+            return STATUS_NO_MEM;
+        r->nSkip            = skip + r->sHost.latency();
+
+        return STATUS_OK;
+    }
+
+    static void close_renderer(renderer_t *r)
+    {
+        if (r->pTelemetry != NULL)
+        {
+            fclose(r->pTelemetry);
+            r->pTelemetry       = NULL;
+        }
+        r->sHost.destroy();
+        r->sIn.close();
+        free_aligned(r->pData);
+        r->vBuf             = NULL;
+    }
+
+    /**
+     * Turn on telemetry of the plugin and create the telemetry file
+     * @param r renderer
+     * @param path path to the telemetry file
+     * @return status of operation
+     */
+    static status_t open_telemetry(renderer_t *r, const char *path)
+    {
+        test::HostPort *p           = r->sHost.port("tlms");
+        if ((p == NULL) || (p->stream() == NULL))
+            return STATUS_NOT_FOUND;
+        r->sHost.set_value("tlm", 1.0f);
+        r->sHost.update_settings();
+
+        if ((r->pTelemetry = fopen(path, "w")) == NULL)
+            return STATUS_IO_ERROR;
+        r->nTelFrame        = p->stream()->frame_id();
+        r->nTelDropped      = 0;
+
+        fprintf(r->pTelemetry, "position;samples;dropped;bypass");
+        for (size_t i=0; i<r->sFormat.channels; ++i)
+            fprintf(r->pTelemetry, ";in_%d;out_%d;gain_%d;alr_%d", int(i), int(i), int(i), int(i));
+        fputc('\n', r->pTelemetry);
+
+        return STATUS_OK;
+    }
+
+    /**
+     * Write telemetry frames published by the plugin since the last call. Frames that have been
+     * overwritten in the stream before they were read are counted as dropped
+     * @param r renderer
+     * @return status of operation
+     */
+    static status_t write_telemetry(renderer_t *r)
+    {
+        plug::stream_t *s           = r->sHost.port("tlms")->stream();
+        const uint32_t last         = s->frame_id();
+        FILE *fd                    = r->pTelemetry;
+        float v[meta::limiter_metadata::TLM_BUFFERS][meta::limiter_metadata::CHANNELS_MAX];
+
+        for (uint32_t id = r->nTelFrame + 1; id != last + 1; ++id)
+        {
+            const ssize_t size          = s->get_frame_size(id);
+            if (size < 0)
+            {
+                ++r->nTelDropped;
+                continue;
+            }
+
+            const size_t count          = lsp_min(size_t(size), size_t(meta::limiter_metadata::CHANNELS_MAX));
+            for (size_t i=0; i<meta::limiter_metadata::TLM_BUFFERS; ++i)
+                s->read_frame(id, i, v[i], 0, count);
+            if (count <= 0)
+                continue;
+
+            const wsize_t position      =
+                wsize_t(v[meta::limiter_metadata::TLM_POS_HIGH][0]) * meta::limiter_metadata::TELEMETRY_POS_SPLIT +
+                wsize_t(v[meta::limiter_metadata::TLM_POS_LOW][0]);
+            const float *flags          = v[meta::limiter_metadata::TLM_FLAGS];
+            fprintf(fd, "%llu;%d;%llu;%d",
+                (unsigned long long)position,
+                int(v[meta::limiter_metadata::TLM_LENGTH][0]),
+                (unsigned long long)r->nTelDropped,
+                (size_t(flags[0]) & meta::limiter_metadata::TF_BYPASS) ? 1 : 0);
+            for (size_t i=0; i<count; ++i)
+                fprintf(fd, ";%.2f;%.2f;%.2f;%d",
+                    dspu::gain_to_db(lsp_max(v[meta::limiter_metadata::TLM_IN_PEAK][i], GAIN_AMP_M_140_DB)),
+                    dspu::gain_to_db(lsp_max(v[meta::limiter_metadata::TLM_OUT_PEAK][i], GAIN_AMP_M_140_DB)),
+                    dspu::gain_to_db(lsp_max(v[meta::limiter_metadata::TLM_GAIN][i], GAIN_AMP_M_140_DB)),
+                    (size_t(flags[i]) & meta::limiter_metadata::TF_ALR) ? 1 : 0);
+            fputc('\n', fd);
+        }
+        r->nTelFrame                = last;
+
+        return (ferror(fd)) ? STATUS_IO_ERROR : STATUS_OK;
+    }
+
+    /**
+     * Render output frames
+     * @param r renderer
+     * @param dst destination buffer for interleaved frames
+     * @param frames number of frames to render
+     * @return number of rendered frames, less than requested at the end of the file, or negative error code
+     */
+    static ssize_t render(renderer_t *r, float *dst, size_t frames)
+    {
+        test::PluginHost *host      = &r->sHost;
+        const size_t channels       = r->sFormat.channels;
+        size_t produced             = 0;
+
+        while (produced < frames)
+        {
+            // Do not produce more output than requested: the plugin state should not run ahead
+            size_t to_do                = lsp_min(host->block_size(), r->nSkip + frames - produced);
+
+            // Fetch input data
+            if (!r->bEof)
+            {
+                const ssize_t read          = r->sIn.read(r->vBuf, to_do);
+                if (read > 0)
+                {
+                    to_do                       = read;
+                    for (size_t i=0; i<channels; ++i)
+                    {
+                        const float *s              = &r->vBuf[i];
+                        float *d                    = host->input(i);
+                        for (size_t j=0; j<to_do; ++j, s += channels)
+                            d[j]                        = *s;
+                    }
+                }
+                else if ((read == 0) || (read == -STATUS_EOF))
+                {
+                    r->bEof                     = true;
+                    r->nTail                    = host->latency();
+                }
+                else
+                    return read;
+            }
+            if (r->bEof)
+            {
+                // Flush the tail of the signal delayed by the plugin
+                if (r->nTail <= 0)
+                    break;
+                to_do                       = lsp_min(to_do, r->nTail);
+                r->nTail                   -= to_do;
+                for (size_t i=0; i<channels; ++i)
+                    dsp::fill_zero(host->input(i), to_do);
+            }
+
+            host->process(to_do);
+            if (r->pTelemetry != NULL)
+            {
+                const status_t res          = write_telemetry(r);
+                if (res != STATUS_OK)
+                    return -ssize_t(res);
+            }
+
+            // Drop the latency and interleave the output
+            const size_t drop           = lsp_min(r->nSkip, to_do);
+            r->nSkip                   -= drop;
+            float *out                  = &dst[produced * channels];
+            for (size_t i=0; i<channels; ++i)
+            {
+                const float *s              = &host->output(i)[drop];
+                float *d                    = &out[i];
+                for (size_t j=drop; j<to_do; ++j, d += channels)
+                    *d                          = *(s++);
+            }
+            produced                   += to_do - drop;
+        }
+
+        return produced;
+    }
+
+    static status_t render_file(batch_t *batch, const char *src, const char *dst)
+    {
+        renderer_t r;
+        mm::OutAudioFileStream os;
+        status_t res;
+
+        lsp_finally { close_renderer(&r); };
+        if ((res = open_renderer(&r, batch, src, 0, 0, true)) != STATUS_OK)
+            return res;
+
+        // Create the output file of the same format
+        if ((res = os.open(dst, &r.sFormat, mm::AFMT_WAV | mm::CFMT_PCM)) != STATUS_OK)
+            return res;
+        lsp_finally { os.close(); };
+
+        uint8_t *data               = NULL;
+        const size_t block          = batch->nBlockSize;
+        float *buf                  = alloc_aligned<float>(data, block * r.sFormat.channels, DEFAULT_ALIGN);
+        if (buf == NULL)
+            return STATUS_NO_MEM;
+        lsp_finally { free_aligned(data); };
+
+        // Enable telemetry, positions are reported relatively to the start of the file
+        if (batch->sTelemetry != NULL)
+        {
+            char path[BATCH_PATH_MAX];
+            snprintf(path, sizeof(path), "%s%s", dst, batch->sTelemetry);
+            if ((res = open_telemetry(&r, path)) != STATUS_OK)
+                return res;
+        }
+
+        // Stream the file through the plugin
+        while (true)
+        {
+            const ssize_t frames        = render(&r, buf, block);
+            if (frames < 0)
+                return status_t(-frames);
+            if (frames == 0)
+                break;
+
+            const ssize_t written       = os.write(buf, frames);
+            if (written < 0)
+                return status_t(-written);
+            if (written != frames)
+                return STATUS_IO_ERROR;
+        }
+
+        return STATUS_OK;
+    }
+
+    //-------------------------------------------------------------------------
+    // Chunk-parallel rendering of a single file
+    typedef struct chunk_t
+    {
+        wsize_t             nStart;         // The first frame of the chunk
+        size_t              nFrames;        // Number of frames in the chunk
+        size_t              nRendered;      // Number of rendered frames
+        float              *vData;          // Rendered interleaved frames
+        bool                bDone;          // Rendering of the chunk is complete
+        ipc::Mutex          sLock;          // Held by the thread rendering the chunk
+    } chunk_t;
+
+    /**
+     * Queue of chunks: each thread takes the next chunk to render, the chunk that is next in the
+     * file is stitched by the first thread that finds it rendered while later chunks are still
+     * being rendered. A thread that has nothing to do waits for the mutex of the thread that holds
+     * up the head of the queue, so no thread spins or sleeps.
+     */
+    typedef struct chunk_queue_t
+    {
+        const batch_t          *pBatch;         // Batch settings
+        const char             *sPath;          // Source file
+        mm::OutAudioFileStream *pOut;           // Output file
+        renderer_t             *pSerial;        // Serial renderer for verification, NULL if not verified
+        float                  *vRef;           // Buffer for frames of serial rendering
+        size_t                  nChannels;      // Number of channels
+        wsize_t                 nLength;        // Length of the file in frames
+        size_t                  nChunkSize;     // Number of frames in the chunk
+        size_t                  nPreroll;       // Number of frames rendered before each chunk
+        size_t                  nBits;          // Number of bits for dithering
+        chunk_t                *vSlots;         // Slots of chunks that are rendered or wait for stitching
+        size_t                  nSlots;         // Number of slots
+        size_t                  nChunks;        // Number of chunks
+        ipc::Mutex              sLock;          // Lock for the fields below and states of chunks
+        ipc::Mutex              sStitch;        // Held by the thread stitching the chunk
+        size_t                  nNext;          // Index of the next chunk to render
+        size_t                  nStitched;      // Number of stitched chunks
+        bool                    bStitching;     // The head of the queue is being stitched
+        float                   fDiff;          // Maximum difference from serial rendering
+        status_t                nStatus;        // Status of rendering
+    } chunk_queue_t;
+
+    static status_t render_chunk(chunk_queue_t *q, chunk_t *c)
+    {
+        // Start rendering earlier: the pre-roll warms up the limiter, ALR, oversampler
+        // and delay state, so the chunk is rendered nearly the same way as in serial rendering
+        const wsize_t preroll   = lsp_min(c->nStart, wsize_t(q->nPreroll));
+        renderer_t r;
+
+        lsp_finally { close_renderer(&r); };
+        const status_t res      = open_renderer(&r, q->pBatch, q->sPath, c->nStart - preroll, preroll, false);
+        if (res != STATUS_OK)
+            return res;
+
+        const ssize_t frames    = render(&r, c->vData, c->nFrames);
+        if (frames < 0)
+            return status_t(-frames);
+        c->nRendered            = frames;
+
+        return STATUS_OK;
+    }
+
+    static float max_difference(const float *a, const float *b, size_t count)
+    {
+        float diff = 0.0f;
+        for (size_t i=0; i<count; ++i)
+            diff        = lsp_max(diff, fabsf(a[i] - b[i]));
+        return diff;
+    }
+
+    static status_t stitch_chunk(chunk_queue_t *q, chunk_t *c, size_t index)
+    {
+        const size_t count          = c->nRendered * q->nChannels;
+
+        if (q->pSerial != NULL)
+        {
+            const ssize_t frames        = render(q->pSerial, q->vRef, c->nRendered);
+            if (frames != ssize_t(c->nRendered))
+                return (frames < 0) ? status_t(-frames) : STATUS_CORRUPTED;
+            q->fDiff                    = lsp_max(q->fDiff, max_difference(c->vData, q->vRef, count));
+        }
+
+        apply_dither(c->vData, count, q->nBits, q->pBatch->nSeed + index);
+
+        const ssize_t written       = q->pOut->write(c->vData, c->nRendered);
+        if (written < 0)
+            return status_t(-written);
+        if (size_t(written) != c->nRendered)
+            return STATUS_IO_ERROR;
+
+        return STATUS_OK;
+    }
+
+    static void process_chunks(chunk_queue_t *q)
+    {
+        q->sLock.lock();
+        while ((q->nStatus == STATUS_OK) && (q->nStitched < q->nChunks))
+        {
+            chunk_t *head               = &q->vSlots[q->nStitched % q->nSlots];
+
+            // Stitch the next chunk of the file as soon as it is rendered
+            if ((!q->bStitching) && (q->nStitched < q->nNext) && (head->bDone))
+            {
+                const size_t index          = q->nStitched;
+                q->bStitching               = true;
+                q->sStitch.lock();
+                q->sLock.unlock();
+
+                const status_t res          = stitch_chunk(q, head, index);
+
+                q->sLock.lock();
+                if ((res != STATUS_OK) && (q->nStatus == STATUS_OK))
+                    q->nStatus                  = res;
+                ++q->nStitched;
+                q->bStitching               = false;
+                q->sStitch.unlock();
+                continue;
+            }
+
+            // Render the next chunk if there is a free slot for it
+            if ((q->nNext < q->nChunks) && (q->nNext < q->nStitched + q->nSlots))
+            {
+                const size_t index          = q->nNext++;
+                chunk_t *c                  = &q->vSlots[index % q->nSlots];
+                c->nStart                   = wsize_t(index) * q->nChunkSize;
+                c->nFrames                  = lsp_min(wsize_t(q->nChunkSize), q->nLength - c->nStart);
+                c->nRendered                = 0;
+                c->bDone                    = false;
+                c->sLock.lock();
+                q->sLock.unlock();
+
+                const status_t res          = render_chunk(q, c);
+
+                q->sLock.lock();
+                if ((res != STATUS_OK) && (q->nStatus == STATUS_OK))
+                    q->nStatus                  = res;
+                c->bDone                    = true;
+                c->sLock.unlock();
+                continue;
+            }
+
+            // All slots are busy: wait for the thread that renders or stitches the head of the queue
+            ipc::Mutex *busy            = (q->bStitching) ? &q->sStitch : &head->sLock;
+            q->sLock.unlock();
+            busy->lock();
+            busy->unlock();
+            q->sLock.lock();
+        }
+        q->sLock.unlock();
+    }
+
+    class ChunkThread: public ipc::Thread
+    {
+        private:
+            chunk_queue_t  *pQueue;
+
+        public:
+            explicit ChunkThread(chunk_queue_t *queue)
+            {
+                pQueue      = queue;
+            }
+
+        public:
+            virtual status_t run() override
+            {
+                process_chunks(pQueue);
+                return STATUS_OK;
+            }
+    };
+
+    static status_t render_file_chunked(batch_t *batch, const char *src, const char *dst, size_t threads)
+    {
+        mm::InAudioFileStream is;
+        mm::OutAudioFileStream os;
+        mm::audio_stream_t fmt;
+        status_t res;
+
+        // Obtain the format of the file and the dithering settings
+        if ((res = is.open(src)) != STATUS_OK)
+            return res;
+        res     = is.info(&fmt);
+        is.close();
+        if (res != STATUS_OK)
+            return res;
+        if (fmt.frames < 0)
+            return STATUS_UNSUPPORTED_FORMAT;
+
+        const meta::plugin_t *meta  = select_plugin(fmt.channels);
+        if (meta == NULL)
+            return STATUS_UNSUPPORTED_FORMAT;
+
+        size_t bits                 = 0;
+        {
+            test::PluginHost host;
+            if ((res = host.init(meta, fmt.srate, batch->nBlockSize)) != STATUS_OK)
+                return res;
+            if ((res = apply_settings(&host, batch)) != STATUS_OK)
+                return res;
+            test::HostPort *p           = host.port("dith");
+            bits                        = (p != NULL) ? dither_bits(p->value()) : 0;
+        }
+
+        // Create the output file
+        if ((res = os.open(dst, &fmt, mm::AFMT_WAV | mm::CFMT_PCM)) != STATUS_OK)
+            return res;
+        lsp_finally { os.close(); };
+
+        const size_t chunk_size     = lsp_max(size_t(batch->fChunk * fmt.srate), size_t(1));
+        const size_t chunks         = (fmt.frames + chunk_size - 1) / chunk_size;
+        const size_t chunk_data     = chunk_size * fmt.channels;
+        threads                     = lsp_limit(threads, size_t(1), lsp_max(chunks, size_t(1)));
+
+        // Each thread renders one chunk, one more slot keeps the rendered chunk while it is stitched
+        const size_t slots          = threads + 1;
+        uint8_t *data               = NULL;
+        float *buf                  = alloc_aligned<float>(data, chunk_data * (slots + 1), DEFAULT_ALIGN);
+        if (buf == NULL)
+            return STATUS_NO_MEM;
+        lsp_finally { free_aligned(data); };
+
+        chunk_t *vslots             = new chunk_t[slots];
+        lsp_finally { delete [] vslots; };
+        for (size_t i=0; i<slots; ++i)
+        {
+            vslots[i].vData             = &buf[chunk_data * i];
+            vslots[i].bDone             = false;
+        }
+
+        // Serial renderer for verification
+        renderer_t serial;
+        init_renderer(&serial);
+        lsp_finally { close_renderer(&serial); };
+        if (batch->bVerify)
+        {
+            if ((res = open_renderer(&serial, batch, src, 0, 0, false)) != STATUS_OK)
+                return res;
+        }
+
+        chunk_queue_t q;
+        q.pBatch                    = batch;
+        q.sPath                     = src;
+        q.pOut                      = &os;
+        q.pSerial                   = (batch->bVerify) ? &serial : NULL;
+        q.vRef                      = &buf[chunk_data * slots];
+        q.nChannels                 = fmt.channels;
+        q.nLength                   = fmt.frames;
+        q.nChunkSize                = chunk_size;
+        q.nPreroll                  = size_t(lsp_max(batch->fPreroll, 0.0f) * fmt.srate);
+        q.nBits                     = bits;
+        q.vSlots                    = vslots;
+        q.nSlots                    = slots;
+        q.nChunks                   = chunks;
+        q.nNext                     = 0;
+        q.nStitched                 = 0;
+        q.bStitching                = false;
+        q.fDiff                     = 0.0f;
+        q.nStatus                   = STATUS_OK;
+
+        // The current thread takes part in rendering, only threads that have been started are joined
+        ChunkThread **workers       = new ChunkThread *[threads];
+        size_t started              = 0;
+        lsp_finally { delete [] workers; };
+        for (size_t i=1; i<threads; ++i)
+        {
+            ChunkThread *t              = new ChunkThread(&q);
+            if (t->start() != STATUS_OK)
+            {
+                delete t;
+                break;
+            }
+            workers[started++]          = t;
+        }
+
+        process_chunks(&q);
+
+        for (size_t i=0; i<started; ++i)
+        {
+            workers[i]->join();
+            delete workers[i];
+        }
+        if (q.nStatus != STATUS_OK)
+            return q.nStatus;
+
+        if (batch->bVerify)
+        {
+            const float diff_db         = dspu::gain_to_db(lsp_max(q.fDiff, GAIN_AMP_M_140_DB));
+            printf("  %s: maximum difference from serial rendering: %.2f dB\n", src, diff_db);
+            if (diff_db > batch->fTolerance)
+                return STATUS_FAILED;
+        }
+
+        return STATUS_OK;
+    }
+
+    class RenderThread: public ipc::Thread
+    {
+        private:
+            batch_t        *pBatch;
+
+        public:
+            explicit RenderThread(batch_t *batch)
+            {
+                pBatch      = batch;
+            }
+
+        public:
+            virtual status_t run() override
+            {
+                char dst[BATCH_PATH_MAX];
+
+                while (true)
+                {
+                    // Fetch the next file
+                    pBatch->sLock.lock();
+                    const size_t index  = pBatch->nNext;
+                    if (index < pBatch->nFiles)
+                        ++pBatch->nNext;
+                    pBatch->sLock.unlock();
+
+                    if (index >= pBatch->nFiles)
+                        break;
+
+                    // Render the file
+                    const char *src     = pBatch->vFiles[index];
+                    make_output_path(dst, sizeof(dst), src, pBatch->sOutDir);
+
+                    const status_t res  = render_file(pBatch, src, dst);
+                    if (res == STATUS_OK)
+                        printf("  %s -> %s\n", src, dst);
+                    else
+                    {
+                        printf("  %s: error %d (%s)\n", src, int(res), get_status(res));
+                        pBatch->sLock.lock();
+                        ++pBatch->nFailed;
+                        pBatch->sLock.unlock();
+                    }
+                }
+
+                return STATUS_OK;
+            }
+    };
+}
+
+MTEST_BEGIN("limiter", batch)
+
+    void usage()
+    {
+        printf("Usage: mtest limiter.batch [-p preset] [-s id=value]... [-o directory] [-j threads] [-b block]\n");
+        printf("                           [-c seconds [-r seconds] [-S seed] [-v tolerance]] [-T suffix] file...\n");
+    }
+
+    MTEST_MAIN
+    {
+        dsp::init();
+
+        batch_t batch;
+        batch.vFiles        = new const char *[argc];
+        batch.vParams       = new const char *[argc];
+        batch.nFiles        = 0;
+        batch.nParams       = 0;
+        batch.sPreset       = NULL;
+        batch.sOutDir       = NULL;
+        batch.nBlockSize    = BATCH_BLOCK_SIZE;
+        batch.fChunk        = 0.0f;
+        batch.fPreroll      = BATCH_PREROLL;
+        batch.nSeed         = 0;
+        batch.bVerify       = false;
+        batch.fTolerance    = BATCH_TOLERANCE;
+        batch.sTelemetry    = NULL;
+        batch.nNext         = 0;
+        batch.nFailed       = 0;
+        lsp_finally {
+            delete [] batch.vFiles;
+            delete [] batch.vParams;
+        };
+
+        size_t threads      = ipc::Thread::system_cores();
+
+        // Parse command line
+        for (int i=0; i<argc; ++i)
+        {
+            const char *arg     = argv[i];
+            if ((arg[0] != '-') || (arg[1] == '\0'))
+            {
+                batch.vFiles[batch.nFiles++]    = arg;
+                continue;
+            }
+            if (i + 1 >= argc)
+            {
+                usage();
+                MTEST_FAIL_MSG("Missing value for option '%s'", arg);
+            }
+
+            const char *value   = argv[++i];
+            if (!strcmp(arg, "-p"))
+                batch.sPreset       = value;
+            else if (!strcmp(arg, "-s"))
+                batch.vParams[batch.nParams++]  = value;
+            else if (!strcmp(arg, "-o"))
+                batch.sOutDir       = value;
+            else if (!strcmp(arg, "-j"))
+                threads             = atoi(value);
+            else if (!strcmp(arg, "-b"))
+                batch.nBlockSize    = atoi(value);
+            else if (!strcmp(arg, "-c"))
+                batch.fChunk        = atof(value);
+            else if (!strcmp(arg, "-r"))
+                batch.fPreroll      = atof(value);
+            else if (!strcmp(arg, "-S"))
+                batch.nSeed         = strtoul(value, NULL, 10);
+            else if (!strcmp(arg, "-T"))
+                batch.sTelemetry    = value;
+            else if (!strcmp(arg, "-v"))
+            {
+                batch.bVerify       = true;
+                batch.fTolerance    = atof(value);
+            }
+            else
+            {
+                usage();
+                MTEST_FAIL_MSG("Unknown option '%s'", arg);
+            }
+        }
+
+        if (batch.nFiles <= 0)
+        {
+            usage();
+            return;
+        }
+        MTEST_ASSERT(batch.nBlockSize > 0);
+        if ((batch.sTelemetry != NULL) && (batch.fChunk > 0.0f))
+        {
+            usage();
+            MTEST_FAIL_MSG("Telemetry is collected only in serial mode");
+        }
+
+        // Process chunks of each file concurrently
+        if (batch.fChunk > 0.0f)
+        {
+            char dst[BATCH_PATH_MAX];
+            threads             = lsp_max(threads, size_t(1));
+            printf("Processing %d files in %.1f s chunks with %d threads\n", int(batch.nFiles), batch.fChunk, int(threads));
+
+            for (size_t i=0; i<batch.nFiles; ++i)
+            {
+                const char *src     = batch.vFiles[i];
+                make_output_path(dst, sizeof(dst), src, batch.sOutDir);
+
+                const status_t res  = render_file_chunked(&batch, src, dst, threads);
+                if (res == STATUS_OK)
+                    printf("  %s -> %s\n", src, dst);
+                else
+                {
+                    printf("  %s: error %d (%s)\n", src, int(res), get_status(res));
+                    ++batch.nFailed;
+                }
+            }
+
+            printf("Processed %d files, %d failed\n", int(batch.nFiles - batch.nFailed), int(batch.nFailed));
+            MTEST_ASSERT(batch.nFailed == 0);
+            return;
+        }
+
+        threads             = lsp_limit(threads, size_t(1), batch.nFiles);
+
+        // Process files concurrently
+        printf("Processing %d files with %d threads\n", int(batch.nFiles), int(threads));
+
+        RenderThread **workers  = new RenderThread *[threads];
+        for (size_t i=0; i<threads; ++i)
+        {
+            workers[i]          = new RenderThread(&batch);
+            MTEST_ASSERT(workers[i]->start() == STATUS_OK);
+        }
+        for (size_t i=0; i<threads; ++i)
+        {
+            workers[i]->join();
+            delete workers[i];
+        }
+        delete [] workers;
+
+        printf("Processed %d files, %d failed\n", int(batch.nFiles - batch.nFailed), int(batch.nFailed));
+        MTEST_ASSERT(batch.nFailed == 0);
+    }
+
+MTEST_END
@@ -0,0 +1,444 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-limiter
+ * Created on: 17 окт. 2026 г.
+ *
+ * lsp-plugins-limiter is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-limiter is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-limiter. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/common/finally.h>
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/dsp/dsp.h>
+#include <lsp-plug.in/plug-fw/plug.h>
+#include <lsp-plug.in/runtime/system.h>
+#include <lsp-plug.in/stdlib/stdio.h>
+#include <lsp-plug.in/stdlib/stdlib.h>
+#include <lsp-plug.in/stdlib/string.h>
+#include <lsp-plug.in/test-fw/helpers.h>
+#include <lsp-plug.in/test-fw/ptest.h>
+
+#include <private/meta/limiter.h>
+#include <private/plugins/limiter.h>
+#include <private/test/host.h>
+
+namespace
+{
+    using namespace lsp;
+
+    static constexpr size_t BENCH_SAMPLE_RATE   = 48000;
+    static constexpr size_t BENCH_WARMUP        = BENCH_SAMPLE_RATE / 10;   // 100 ms of warm-up
+    static constexpr size_t BENCH_DURATION      = BENCH_SAMPLE_RATE * 2;    // 2 s of measured audio
+    static constexpr size_t BENCH_MAX_BLOCK     = 8192;
+    static constexpr size_t BENCH_MODE_BLOCK    = 1024;
+    static constexpr size_t BASELINE_MAX        = 0x2000;   // Maximum number of entries in the baseline file
+    static constexpr size_t BASELINE_KEY_MAX    = 64;
+    static constexpr float  BASELINE_TOLERANCE  = 20.0f;    // Default allowed regression of ns/sample [%]
+
+    /**
+     * Performance gate: when the LSP_LIMITER_PERF_BASELINE environment variable points to the
+     * baseline file, each measured ns/sample is compared with the baseline of the same machine and
+     * the test fails if it regresses more than LSP_LIMITER_PERF_TOLERANCE percent (20% by default).
+     * When LSP_LIMITER_PERF_UPDATE is set, the baseline file is written instead.
+     */
+    typedef struct baseline_t
+    {
+        char        key[BASELINE_KEY_MAX];      // Plugin, oversampling, mode, sidechain and block size
+        double      ns;                         // Time per sample [ns]
+    } baseline_t;
+
+    typedef struct gate_t
+    {
+        baseline_t *vItems;                     // Baseline entries
+        size_t      nItems;                     // Number of baseline entries
+        FILE       *pOut;                       // Baseline file being written
+        double      fTolerance;                 // Allowed regression, ratio
+        size_t      nRegressed;                 // Number of regressed cases
+        size_t      nMissing;                   // Number of cases not present in the baseline
+    } gate_t;
+
+    static const size_t block_sizes[] =
+    {
+        16, 32, 64, 128, 256, 512, 1024, 2048, 4096, 8192
+    };
+
+    static const size_t calibration_modes[] =
+    {
+        meta::limiter_metadata::OVS_NONE,
+        meta::limiter_metadata::OVS_FULL_2X24BIT,
+        meta::limiter_metadata::OVS_FULL_4X24BIT,
+        meta::limiter_metadata::OVS_FULL_8X24BIT,
+        meta::limiter_metadata::OVS_TRUE_PEAK_24BIT
+    };
+
+    static const char *profile_stages[] =
+    {
+        "premix",
+        "upsample",
+        "sidechain",
+        "limit",
+        "link",
+        "metering",
+        "downsample",
+        "dither",
+        "bypass",
+        "history"
+    };
+
+    static const meta::plugin_t *bench_plugins[] =
+    {
+        &meta::limiter_mono,
+        &meta::limiter_stereo,
+        &meta::sc_limiter_mono,
+        &meta::sc_limiter_stereo,
+        &meta::limiter_5_1,
+        &meta::limiter_7_1,
+        &meta::limiter_7_1_4
+    };
+
+    static const char *port_item(const meta::plugin_t *meta, const char *id, size_t index)
+    {
+        for (const meta::port_t *p = meta->ports; p->id != NULL; ++p)
+        {
+            if ((strcmp(p->id, id)) || (p->items == NULL))
+                continue;
+            for (size_t i=0; p->items[i].text != NULL; ++i)
+                if (i == index)
+                    return p->items[i].text;
+        }
+        return "-";
+    }
+
+    static size_t port_items(const meta::plugin_t *meta, const char *id)
+    {
+        for (const meta::port_t *p = meta->ports; p->id != NULL; ++p)
+        {
+            if ((strcmp(p->id, id)) || (p->items == NULL))
+                continue;
+            size_t count = 0;
+            while (p->items[count].text != NULL)
+                ++count;
+            return count;
+        }
+        return 0;
+    }
+
+    static void process_audio(test::PluginHost *h, size_t block, size_t samples)
+    {
+        for (size_t offset=0; offset < samples; offset += block)
+            h->process(lsp_min(block, samples - offset));
+    }
+
+    static double elapsed_ns(const system::time_t *start, const system::time_t *end)
+    {
+        return double(end->seconds - start->seconds) * 1e+9 + (double(end->nanos) - double(start->nanos));
+    }
+
+    static bool load_baseline(gate_t *gate, const char *path)
+    {
+        FILE *fd        = fopen(path, "r");
+        if (fd == NULL)
+            return false;
+        lsp_finally { fclose(fd); };
+
+        char line[BASELINE_KEY_MAX * 2];
+        while ((gate->nItems < BASELINE_MAX) && (fgets(line, sizeof(line), fd) != NULL))
+        {
+            // Each line has 'key ns' form, the key has no spaces
+            baseline_t *b   = &gate->vItems[gate->nItems];
+            char *split     = strchr(line, ' ');
+            if ((line[0] == '#') || (split == NULL) || (size_t(split - line) >= BASELINE_KEY_MAX))
+                continue;
+
+            *(split++)      = '\0';
+            strcpy(b->key, line);
+            b->ns           = atof(split);
+            if (b->ns > 0.0)
+                ++gate->nItems;
+        }
+
+        return true;
+    }
+
+    static const baseline_t *find_baseline(const gate_t *gate, const char *key)
+    {
+        for (size_t i=0; i<gate->nItems; ++i)
+            if (!strcmp(gate->vItems[i].key, key))
+                return &gate->vItems[i];
+        return NULL;
+    }
+}
+
+PTEST_BEGIN("limiter", limiter, 1, 1)
+
+    gate_t  sGate;
+
+    void bench(const meta::plugin_t *meta, size_t ovs, size_t mode, size_t sc, size_t block)
+    {
+        test::PluginHost h;
+        if (h.init(meta, BENCH_SAMPLE_RATE, BENCH_MAX_BLOCK) != STATUS_OK)
+            PTEST_FAIL_MSG("Could not instantiate plugin '%s'", meta->uid);
+
+        // Fill inputs with loud noise
+        for (size_t i=0; i<h.inputs(); ++i)
+        {
+            randomize_sign(h.input(i), BENCH_MAX_BLOCK);
+            dsp::mul_k2(h.input(i), GAIN_AMP_P_12_DB, BENCH_MAX_BLOCK);
+        }
+
+        // Measure the worst case: metering is active as if the UI was shown
+        h.module()->ui_activated();
+
+        h.set_value("ovs", ovs);
+        h.set_value("mode", mode);
+        if (h.port("extsc") != NULL)
+            h.set_value("extsc", sc);
+        h.update_settings();
+
+        // Warm up the delay lines, oversamplers and the limiter state
+        process_audio(&h, block, BENCH_WARMUP);
+
+        system::time_t start, end;
+        system::get_time(&start);
+        process_audio(&h, block, BENCH_DURATION);
+        system::get_time(&end);
+
+        const double ns     = elapsed_ns(&start, &end) / BENCH_DURATION;
+        printf("%-20s %-18s %-10s %-10s %6d %10.2f %10.2f",
+            meta->uid,
+            port_item(meta, "ovs", ovs),
+            port_item(meta, "mode", mode),
+            port_item(meta, "extsc", sc),
+            int(block),
+            ns,
+            ns / lsp_max(h.outputs(), size_t(1)));
+
+        // Check the performance gate
+        char key[BASELINE_KEY_MAX];
+        snprintf(key, sizeof(key), "%s:%d:%d:%d:%d", meta->uid, int(ovs), int(mode), int(sc), int(block));
+
+        if (sGate.pOut != NULL)
+            fprintf(sGate.pOut, "%s %.3f\n", key, ns);
+        else if (sGate.vItems != NULL)
+        {
+            const baseline_t *b = find_baseline(&sGate, key);
+            if (b == NULL)
+                ++sGate.nMissing;
+            else if (ns > b->ns * (1.0 + sGate.fTolerance))
+            {
+                printf(" REGRESSED %+.1f%%", (ns / b->ns - 1.0) * 100.0);
+                ++sGate.nRegressed;
+            }
+        }
+        printf("\n");
+    }
+
+    void init_gate()
+    {
+        sGate.vItems        = NULL;
+        sGate.nItems        = 0;
+        sGate.pOut          = NULL;
+        sGate.fTolerance    = BASELINE_TOLERANCE * 0.01;
+        sGate.nRegressed    = 0;
+        sGate.nMissing      = 0;
+
+        const char *path    = getenv("LSP_LIMITER_PERF_BASELINE");
+        if ((path == NULL) || (path[0] == '\0'))
+            return;
+
+        const char *tol     = getenv("LSP_LIMITER_PERF_TOLERANCE");
+        if ((tol != NULL) && (tol[0] != '\0'))
+            sGate.fTolerance    = atof(tol) * 0.01;
+
+        const char *update  = getenv("LSP_LIMITER_PERF_UPDATE");
+        if ((update != NULL) && (update[0] != '\0'))
+        {
+            if ((sGate.pOut = fopen(path, "w")) == NULL)
+                PTEST_FAIL_MSG("Could not create baseline file '%s'", path);
+            fprintf(sGate.pOut, "# plugin:ovs:mode:sidechain:block ns/sample\n");
+            return;
+        }
+
+        sGate.vItems        = new baseline_t[BASELINE_MAX];
+        if (!load_baseline(&sGate, path))
+            PTEST_FAIL_MSG("Could not read baseline file '%s'", path);
+    }
+
+    void check_gate()
+    {
+        if (sGate.pOut != NULL)
+        {
+            fclose(sGate.pOut);
+            sGate.pOut          = NULL;
+            return;
+        }
+        if (sGate.vItems == NULL)
+            return;
+
+        delete [] sGate.vItems;
+        sGate.vItems        = NULL;
+
+        if (sGate.nMissing > 0)
+            printf("%d cases are not present in the baseline\n", int(sGate.nMissing));
+        if (sGate.nRegressed > 0)
+            PTEST_FAIL_MSG("%d cases regressed more than %.1f%% against the baseline",
+                int(sGate.nRegressed), sGate.fTolerance * 100.0);
+    }
+
+    double measure(test::PluginHost *h)
+    {
+        system::time_t start, end;
+        system::get_time(&start);
+        process_audio(h, BENCH_MAX_BLOCK, BENCH_DURATION);
+        system::get_time(&end);
+
+        return elapsed_ns(&start, &end) / BENCH_DURATION;
+    }
+
+    void calibrate(const meta::plugin_t *meta, size_t ovs)
+    {
+        test::PluginHost h;
+        if (h.init(meta, BENCH_SAMPLE_RATE, BENCH_MAX_BLOCK) != STATUS_OK)
+            PTEST_FAIL_MSG("Could not instantiate plugin '%s'", meta->uid);
+
+        for (size_t i=0; i<h.inputs(); ++i)
+        {
+            randomize_sign(h.input(i), BENCH_MAX_BLOCK);
+            dsp::mul_k2(h.input(i), GAIN_AMP_P_12_DB, BENCH_MAX_BLOCK);
+        }
+
+        h.module()->ui_activated();
+        h.set_value("ovs", ovs);
+        h.update_settings();
+
+        // Large host blocks are split into internal blocks, measure the adaptive block size
+        plugins::limiter *l = static_cast<plugins::limiter *>(h.module());
+        const size_t adaptive   = l->block_size();
+        process_audio(&h, BENCH_MAX_BLOCK, BENCH_WARMUP);
+        const double ns_adaptive= measure(&h);
+
+        // Calibrate and measure the fastest block size
+        l->calibrate();
+        while (l->calibrating())
+            h.process(BENCH_MAX_BLOCK);
+        const size_t calibrated = l->block_size();
+        const double ns_calibrated = measure(&h);
+
+        printf("%-20s %-18s %8d %10.2f %8d %10.2f\n",
+            meta->uid,
+            port_item(meta, "ovs", ovs),
+            int(adaptive),
+            ns_adaptive,
+            int(calibrated),
+            ns_calibrated);
+    }
+
+    void profile(const meta::plugin_t *meta, size_t ovs)
+    {
+        test::PluginHost h;
+        if (h.init(meta, BENCH_SAMPLE_RATE, BENCH_MAX_BLOCK) != STATUS_OK)
+            PTEST_FAIL_MSG("Could not instantiate plugin '%s'", meta->uid);
+
+        for (size_t i=0; i<h.inputs(); ++i)
+        {
+            randomize_sign(h.input(i), BENCH_MAX_BLOCK);
+            dsp::mul_k2(h.input(i), GAIN_AMP_P_12_DB, BENCH_MAX_BLOCK);
+        }
+
+        h.module()->ui_activated();
+        h.set_value("ovs", ovs);
+        h.update_settings();
+
+        // Processing stages are profiled by the plugin itself, times are shown in ns/sample
+        plugins::limiter *l = static_cast<plugins::limiter *>(h.module());
+        process_audio(&h, BENCH_MODE_BLOCK, BENCH_WARMUP);
+        l->set_profiling(true);
+        process_audio(&h, BENCH_MODE_BLOCK, BENCH_DURATION);
+        l->set_profiling(false);
+
+        const double samples    = double(lsp_max(l->profiled_samples(), wsize_t(1)));
+        printf("%-20s %-18s", meta->uid, port_item(meta, "ovs", ovs));
+        for (size_t i=0; i<plugins::limiter::PS_TOTAL; ++i)
+            printf(" %10.2f", double(l->profile(i)) / samples);
+        printf(" %8.1f\n", l->cpu_load());
+    }
+
+    void header()
+    {
+        printf("%-20s %-18s %-10s %-10s %6s %10s %10s\n",
+            "plugin", "oversampling", "mode", "sidechain", "block", "ns/sample", "ns/s/chan");
+    }
+
+    PTEST_MAIN
+    {
+        dsp::init();
+        init_gate();
+
+        for (size_t i=0; i<sizeof(bench_plugins)/sizeof(bench_plugins[0]); ++i)
+        {
+            const meta::plugin_t *meta = bench_plugins[i];
+            const size_t sc_modes = port_items(meta, "extsc");
+
+            // Oversampling modes for all host block sizes
+            header();
+            for (size_t ovs=meta::limiter_metadata::OVS_NONE; ovs<=meta::limiter_metadata::OVS_SIDECHAIN_8X; ++ovs)
+                for (size_t j=0; j<sizeof(block_sizes)/sizeof(block_sizes[0]); ++j)
+                    bench(meta, ovs, meta::limiter_metadata::LOM_DEFAULT, 0, block_sizes[j]);
+            PTEST_SEPARATOR;
+
+            // Limiter curves without and with maximum oversampling
+            header();
+            for (size_t mode=meta::limiter_metadata::LOM_HERM_THIN; mode<=meta::limiter_metadata::LOM_LINE_DUCK; ++mode)
+            {
+                bench(meta, meta::limiter_metadata::OVS_NONE, mode, 0, BENCH_MODE_BLOCK);
+                bench(meta, meta::limiter_metadata::OVS_FULL_8X24BIT, mode, 0, BENCH_MODE_BLOCK);
+            }
+            PTEST_SEPARATOR;
+
+            // Adaptive and calibrated internal block size
+            printf("%-20s %-18s %8s %10s %8s %10s\n",
+                "plugin", "oversampling", "adaptive", "ns/sample", "calibr", "ns/sample");
+            for (size_t j=0; j<sizeof(calibration_modes)/sizeof(calibration_modes[0]); ++j)
+                calibrate(meta, calibration_modes[j]);
+            PTEST_SEPARATOR;
+
+            // Time spent at processing stages
+            printf("%-20s %-18s", "plugin", "oversampling");
+            for (size_t j=0; j<plugins::limiter::PS_TOTAL; ++j)
+                printf(" %10s", profile_stages[j]);
+            printf(" %8s\n", "cpu %");
+            for (size_t j=0; j<sizeof(calibration_modes)/sizeof(calibration_modes[0]); ++j)
+                profile(meta, calibration_modes[j]);
+            PTEST_SEPARATOR;
+
+            // Sidechain modes, surround versions have only the internal sidechain
+            if (sc_modes > 0)
+            {
+                header();
+                for (size_t sc=0; sc<sc_modes; ++sc)
+                {
+                    bench(meta, meta::limiter_metadata::OVS_NONE, meta::limiter_metadata::LOM_DEFAULT, sc, BENCH_MODE_BLOCK);
+                    bench(meta, meta::limiter_metadata::OVS_FULL_8X24BIT, meta::limiter_metadata::LOM_DEFAULT, sc, BENCH_MODE_BLOCK);
+                }
+            }
+            PTEST_SEPARATOR2;
+        }
+
+        check_gate();
+    }
+
+PTEST_END
+
+
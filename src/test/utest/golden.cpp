@@ -0,0 +1,437 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-limiter
+ * Created on: 17 окт. 2026 г.
+ *
+ * lsp-plugins-limiter is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-limiter is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-limiter. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/common/finally.h>
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/dsp/dsp.h>
+#include <lsp-plug.in/dsp-units/units.h>
+#include <lsp-plug.in/dsp-units/util/Randomizer.h>
+#include <lsp-plug.in/plug-fw/plug.h>
+#include <lsp-plug.in/stdlib/math.h>
+#include <lsp-plug.in/stdlib/stdio.h>
+#include <lsp-plug.in/stdlib/stdlib.h>
+#include <lsp-plug.in/stdlib/string.h>
+#include <lsp-plug.in/test-fw/utest.h>
+
+#include <private/meta/limiter.h>
+#include <private/test/host.h>
+
+/**
+ * Golden output regression test: reference signals are rendered through the limiter with each
+ * limiter mode and each oversampling mode. The output is reduced to a fingerprint: peak and RMS
+ * of each window of each channel. Fingerprints are compared with the golden files stored in
+ * 'limiter/golden/<plugin>.golden' of the test resources with a tolerance, so optimizations of
+ * process() that change rounding of floating-point operations do not break the test.
+ *
+ * The golden files are generated by the reference build which precedes the optimizations of the
+ * process() method, and are regenerated only after an intended change of the audio output, by
+ * running the test with the LSP_LIMITER_GOLDEN_UPDATE environment variable set. The new golden
+ * file replaces the old one only if it has been completely written. If the golden file of the
+ * plugin is missing, the comparison is skipped with a message and only the invariants of the
+ * output are checked.
+ */
+namespace
+{
+    using namespace lsp;
+
+    static constexpr size_t GOLDEN_SAMPLE_RATE  = 48000;
+    static constexpr size_t GOLDEN_BLOCK_SIZE   = 1024;
+    static constexpr size_t GOLDEN_LENGTH       = 8192;     // Length of each reference signal [samples]
+    static constexpr size_t GOLDEN_WINDOW       = 256;      // Window of the fingerprint [samples]
+    static constexpr size_t GOLDEN_WINDOWS      = GOLDEN_LENGTH / GOLDEN_WINDOW;
+    static constexpr size_t GOLDEN_NAME_MAX     = 64;
+    static constexpr size_t GOLDEN_PATH_MAX     = 1024;
+    static constexpr uint32_t GOLDEN_MAGIC      = 0x4c535047;   // 'LSPG'
+    static constexpr uint32_t GOLDEN_VERSION    = 1;
+    static constexpr float  GOLDEN_TOLERANCE    = 0.1f;     // Tolerance of the fingerprint [dB]
+    static constexpr float  GOLDEN_FLOOR        = GAIN_AMP_M_120_DB;
+    static constexpr float  PEAK_TOLERANCE      = 1.5f;     // Allowed overshoot of the output over the threshold [dB]
+
+    enum signal_t
+    {
+        SIG_SINE_BURST,                 // Bursts of the loud sine wave with hard edges
+        SIG_ISP_TONE,                   // Quarter of the sample rate tone with inter-sample peaks 3 dB above the sample peaks
+        SIG_TRANSIENTS,                 // Noise with sharp decaying hits
+
+        SIG_TOTAL
+    };
+
+    static const char *signal_names[] =
+    {
+        "burst",
+        "isp",
+        "transients"
+    };
+
+    static const meta::plugin_t *golden_plugins[] =
+    {
+        &meta::limiter_mono,
+        &meta::limiter_stereo,
+        &meta::sc_limiter_mono,
+        &meta::sc_limiter_stereo
+    };
+
+    typedef struct golden_case_t
+    {
+        char        name[GOLDEN_NAME_MAX];
+        size_t      signal;
+        size_t      ovs;
+        size_t      mode;
+    } golden_case_t;
+
+    static void generate_signal(float *dst, size_t signal, size_t channel, size_t count)
+    {
+        switch (signal)
+        {
+            case SIG_SINE_BURST:
+            {
+                // 24 ms bursts with 24 ms pauses, channels have slightly different frequencies
+                const float amp     = GAIN_AMP_P_6_DB;
+                const float w       = 2.0f * M_PI * (997.0f + channel * 50.0f) / GOLDEN_SAMPLE_RATE;
+                const size_t period = (GOLDEN_SAMPLE_RATE * 24) / 1000;
+                for (size_t i=0; i<count; ++i)
+                    dst[i]              = (((i / period) & 1) == 0) ? amp * sinf(w * i) : 0.0f;
+                break;
+            }
+
+            case SIG_ISP_TONE:
+            {
+                // Samples of fs/4 tone shifted by 45 degrees are 3 dB below its true peak
+                const float amp     = M_SQRT2;
+                for (size_t i=0; i<count; ++i)
+                    dst[i]              = amp * sinf(M_PI_2 * i + M_PI_4 * (channel * 2 + 1));
+                break;
+            }
+
+            case SIG_TRANSIENTS:
+            default:
+            {
+                // Background noise with hits each 50 ms decaying by 60 dB over 20 ms
+                dspu::Randomizer rnd;
+                rnd.init(uint32_t(channel + 1) * 0x9e3779b9U);
+
+                const size_t period = (GOLDEN_SAMPLE_RATE * 50) / 1000;
+                const float decay   = logf(GAIN_AMP_M_60_DB) / ((GOLDEN_SAMPLE_RATE * 20) / 1000);
+                for (size_t i=0; i<count; ++i)
+                {
+                    const float env     = GAIN_AMP_P_12_DB * expf(decay * (i % period)) + GAIN_AMP_M_24_DB;
+                    dst[i]              = (rnd.random(dspu::RND_LINEAR) * 2.0f - 1.0f) * env;
+                }
+                break;
+            }
+        }
+    }
+
+    static size_t make_cases(golden_case_t *cases)
+    {
+        size_t count = 0;
+        for (size_t signal=0; signal<SIG_TOTAL; ++signal)
+        {
+            // Limiter modes without oversampling and with true peak detection
+            for (size_t mode=meta::limiter_metadata::LOM_HERM_THIN; mode<=meta::limiter_metadata::LOM_LINE_DUCK; ++mode)
+            {
+                const size_t ovs_modes[] = { meta::limiter_metadata::OVS_NONE, meta::limiter_metadata::OVS_TRUE_PEAK_24BIT };
+                for (size_t j=0; j<2; ++j)
+                {
+                    golden_case_t *c    = &cases[count++];
+                    c->signal           = signal;
+                    c->ovs              = ovs_modes[j];
+                    c->mode             = mode;
+                }
+            }
+
+            // All oversampling modes with the default limiter mode
+            for (size_t ovs=meta::limiter_metadata::OVS_NONE; ovs<=meta::limiter_metadata::OVS_SIDECHAIN_8X; ++ovs)
+            {
+                if ((ovs == meta::limiter_metadata::OVS_NONE) || (ovs == meta::limiter_metadata::OVS_TRUE_PEAK_24BIT))
+                    continue;
+
+                golden_case_t *c    = &cases[count++];
+                c->signal           = signal;
+                c->ovs              = ovs;
+                c->mode             = meta::limiter_metadata::LOM_DEFAULT;
+            }
+        }
+
+        for (size_t i=0; i<count; ++i)
+        {
+            golden_case_t *c    = &cases[i];
+            snprintf(c->name, sizeof(c->name), "%s.ovs%d.mode%d", signal_names[c->signal], int(c->ovs), int(c->mode));
+        }
+
+        return count;
+    }
+
+    static bool write_u32(FILE *fd, uint32_t value)
+    {
+        return fwrite(&value, sizeof(value), 1, fd) == 1;
+    }
+
+    static bool read_u32(FILE *fd, uint32_t *value)
+    {
+        return fread(value, sizeof(uint32_t), 1, fd) == 1;
+    }
+
+    static bool write_string(FILE *fd, const char *s)
+    {
+        const uint32_t len = strlen(s);
+        return (write_u32(fd, len)) && (fwrite(s, sizeof(char), len, fd) == len);
+    }
+
+    static bool read_string(FILE *fd, char *s, size_t size)
+    {
+        uint32_t len;
+        if ((!read_u32(fd, &len)) || (len >= size))
+            return false;
+        if (fread(s, sizeof(char), len, fd) != len)
+            return false;
+        s[len] = '\0';
+        return true;
+    }
+
+    static size_t audio_outputs(const meta::plugin_t *meta)
+    {
+        size_t count = 0;
+        for (const meta::port_t *p = meta->ports; p->id != NULL; ++p)
+            if (p->role == meta::R_AUDIO_OUT)
+                ++count;
+        return count;
+    }
+
+    static float fingerprint_db(float value)
+    {
+        return dspu::gain_to_db(lsp_max(value, GOLDEN_FLOOR));
+    }
+}
+
+UTEST_BEGIN("limiter", golden)
+
+    /**
+     * Render the case and compute the fingerprint of the output
+     * @param meta plugin metadata
+     * @param c case to render
+     * @param signal input signal of each channel
+     * @param fp fingerprint: peak and RMS of each window of each channel
+     */
+    void render(const meta::plugin_t *meta, const golden_case_t *c, float * const *signal, float *fp)
+    {
+        test::PluginHost h;
+        UTEST_ASSERT_MSG(h.init(meta, GOLDEN_SAMPLE_RATE, GOLDEN_BLOCK_SIZE) == STATUS_OK,
+            "Could not instantiate plugin '%s'", meta->uid);
+
+        // Sidechain inputs receive the signal of the corresponding channel, so the external
+        // sidechain of sidechain variants produces the same gain curve as the internal one
+        const size_t channels   = h.outputs();
+        const bool sidechain    = h.inputs() > channels;
+
+        h.set_value("ovs", c->ovs);
+        h.set_value("mode", c->mode);
+        h.set_value("extsc", (sidechain) ? 1 : 0);
+        h.set_value("dith", meta::limiter_metadata::DITHER_NONE);
+        h.update_settings();
+
+        const float threshold   = dspu::db_to_gain(PEAK_TOLERANCE);
+
+        for (size_t offset=0; offset < GOLDEN_LENGTH; offset += GOLDEN_BLOCK_SIZE)
+        {
+            const size_t to_do      = lsp_min(GOLDEN_LENGTH - offset, GOLDEN_BLOCK_SIZE);
+            for (size_t i=0; i<h.inputs(); ++i)
+                dsp::copy(h.input(i), &signal[i % channels][offset], to_do);
+
+            h.process(to_do);
+
+            for (size_t i=0; i<channels; ++i)
+            {
+                const float *out        = h.output(i);
+                for (size_t j=0; j<to_do; j += GOLDEN_WINDOW)
+                {
+                    const size_t count      = lsp_min(to_do - j, GOLDEN_WINDOW);
+                    const size_t window     = (offset + j) / GOLDEN_WINDOW;
+                    const float peak        = dsp::abs_max(&out[j], count);
+                    const float rms         = sqrtf(dsp::h_sqr_sum(&out[j], count) / count);
+
+                    // Invariants that do not depend on golden files
+                    UTEST_ASSERT_MSG((!isnan(peak)) && (!isinf(peak)),
+                        "%s %s: output of channel %d is not finite at window %d", meta->uid, c->name, int(i), int(window));
+                    UTEST_ASSERT_MSG(peak <= threshold,
+                        "%s %s: output of channel %d exceeds the threshold: %.2f dB at window %d",
+                        meta->uid, c->name, int(i), dspu::gain_to_db(peak), int(window));
+
+                    fp[(i * GOLDEN_WINDOWS + window) * 2]       = peak;
+                    fp[(i * GOLDEN_WINDOWS + window) * 2 + 1]   = rms;
+                }
+            }
+        }
+    }
+
+    void compare(const meta::plugin_t *meta, const golden_case_t *c, const float *fp, const float *gfp, size_t channels)
+    {
+        for (size_t i=0; i<channels; ++i)
+            for (size_t j=0; j<GOLDEN_WINDOWS; ++j)
+                for (size_t k=0; k<2; ++k)
+                {
+                    const size_t index  = (i * GOLDEN_WINDOWS + j) * 2 + k;
+                    const float v       = fingerprint_db(fp[index]);
+                    const float g       = fingerprint_db(gfp[index]);
+                    UTEST_ASSERT_MSG(fabsf(v - g) <= GOLDEN_TOLERANCE,
+                        "%s %s: %s of channel %d at window %d differs from golden: %.3f dB vs %.3f dB",
+                        meta->uid, c->name, (k == 0) ? "peak" : "RMS", int(i), int(j), v, g);
+                }
+    }
+
+    void test_plugin(const meta::plugin_t *meta, bool update)
+    {
+        // Prepare cases and reference signals
+        golden_case_t cases[SIG_TOTAL * (meta::limiter_metadata::LOM_LINE_DUCK + 1) * 2 + SIG_TOTAL * (meta::limiter_metadata::OVS_SIDECHAIN_8X + 1)];
+        const size_t n_cases    = make_cases(cases);
+        const size_t channels   = audio_outputs(meta);
+        const size_t fp_size    = channels * GOLDEN_WINDOWS * 2;
+
+        float *signals[SIG_TOTAL][2];
+        float *fp               = new float[fp_size * 2];
+        float *gfp              = &fp[fp_size];
+        float *data             = new float[SIG_TOTAL * channels * GOLDEN_LENGTH];
+        lsp_finally {
+            delete [] fp;
+            delete [] data;
+        };
+
+        for (size_t i=0; i<SIG_TOTAL; ++i)
+            for (size_t j=0; j<channels; ++j)
+            {
+                signals[i][j]           = &data[(i * channels + j) * GOLDEN_LENGTH];
+                generate_signal(signals[i][j], i, j, GOLDEN_LENGTH);
+            }
+
+        // Open the golden file. The updated golden file is written to the temporary file which
+        // replaces the golden file only after all cases have been written successfully
+        char path[GOLDEN_PATH_MAX], tmp_path[GOLDEN_PATH_MAX];
+        snprintf(path, sizeof(path), "%s/limiter/golden/%s.golden", resources(), meta->uid);
+        snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+        FILE *fd                = fopen((update) ? tmp_path : path, (update) ? "wb" : "rb");
+        UTEST_ASSERT_MSG((fd != NULL) || (!update),
+            "Could not create golden file '%s'", tmp_path);
+        lsp_finally {
+            if (fd != NULL)
+                fclose(fd);
+            if (update)
+                remove(tmp_path);
+        };
+
+        char name[GOLDEN_NAME_MAX];
+        uint32_t magic, version, srate, length, window, count, n_channels;
+
+        // Without the golden file only the invariants of the output are checked
+        const bool golden       = fd != NULL;
+        if (!golden)
+        {
+            printf("  %s: golden file '%s' is missing, comparison with golden output is SKIPPED; "
+                "golden files are generated by the reference build with LSP_LIMITER_GOLDEN_UPDATE "
+                "environment variable set\n", meta->uid, path);
+        }
+        else if (update)
+        {
+            UTEST_ASSERT_MSG(
+                (write_u32(fd, GOLDEN_MAGIC)) &&
+                (write_u32(fd, GOLDEN_VERSION)) &&
+                (write_string(fd, meta->uid)) &&
+                (write_u32(fd, GOLDEN_SAMPLE_RATE)) &&
+                (write_u32(fd, GOLDEN_LENGTH)) &&
+                (write_u32(fd, GOLDEN_WINDOW)) &&
+                (write_u32(fd, n_cases)) &&
+                (write_u32(fd, channels)),
+                "Could not write header of golden file '%s'", path);
+        }
+        else
+        {
+            UTEST_ASSERT_MSG(
+                (read_u32(fd, &magic)) && (magic == GOLDEN_MAGIC) &&
+                (read_u32(fd, &version)) && (version == GOLDEN_VERSION),
+                "Unsupported format of golden file '%s'", path);
+            UTEST_ASSERT_MSG(
+                (read_string(fd, name, sizeof(name))) &&
+                (read_u32(fd, &srate)) &&
+                (read_u32(fd, &length)) &&
+                (read_u32(fd, &window)) &&
+                (read_u32(fd, &count)) &&
+                (read_u32(fd, &n_channels)),
+                "Corrupted header of golden file '%s'", path);
+            UTEST_ASSERT_MSG(
+                (!strcmp(name, meta->uid)) &&
+                (srate == GOLDEN_SAMPLE_RATE) &&
+                (length == GOLDEN_LENGTH) &&
+                (window == GOLDEN_WINDOW) &&
+                (count == n_cases) &&
+                (n_channels == channels),
+                "Golden file '%s' does not match the test, regenerate it", path);
+        }
+
+        // Render cases
+        for (size_t i=0; i<n_cases; ++i)
+        {
+            const golden_case_t *c  = &cases[i];
+            float *signal[2]        = { signals[c->signal][0], signals[c->signal][channels - 1] };
+            render(meta, c, signal, fp);
+
+            if (!golden)
+                continue;
+            if (update)
+            {
+                UTEST_ASSERT_MSG(
+                    (write_string(fd, c->name)) &&
+                    (fwrite(fp, sizeof(float), fp_size, fd) == fp_size),
+                    "Could not write golden file '%s'", path);
+                continue;
+            }
+
+            UTEST_ASSERT_MSG(
+                (read_string(fd, name, sizeof(name))) &&
+                (fread(gfp, sizeof(float), fp_size, fd) == fp_size),
+                "Corrupted golden file '%s'", path);
+            UTEST_ASSERT_MSG(!strcmp(name, c->name),
+                "Golden file '%s' has case '%s' instead of '%s', regenerate it", path, name, c->name);
+            compare(meta, c, fp, gfp, channels);
+        }
+
+        if (update)
+        {
+            const bool closed       = fclose(fd) == 0;
+            fd                      = NULL;
+            UTEST_ASSERT_MSG((closed) && (rename(tmp_path, path) == 0),
+                "Could not replace golden file '%s'", path);
+        }
+
+        printf("  %s: %d cases %s\n", meta->uid, int(n_cases),
+            (update) ? "written" : (golden) ? "passed" : "passed invariants only");
+    }
+
+    UTEST_MAIN
+    {
+        const char *env     = getenv("LSP_LIMITER_GOLDEN_UPDATE");
+        const bool update   = (env != NULL) && (env[0] != '\0');
+
+        for (size_t i=0; i<sizeof(golden_plugins)/sizeof(golden_plugins[0]); ++i)
+            test_plugin(golden_plugins[i], update);
+    }
+
+UTEST_END
+
+
@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-limiter
+ * Created on: 17 окт. 2026 г.
+ *
+ * lsp-plugins-limiter is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-limiter is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-limiter. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/dsp/dsp.h>
+#include <lsp-plug.in/dsp-units/units.h>
+#include <lsp-plug.in/plug-fw/plug.h>
+#include <lsp-plug.in/stdlib/math.h>
+
+#include <private/meta/limiter.h>
+#include <private/test/host.h>
+
+/**
+ * Stereo linking test: the loud transient of the right channel enters the lookahead while the
+ * channels are fully linked, and the linking is dropped to 50% before the transient reaches the
+ * output. The limiter of the right channel has to keep the transient under the threshold.
+ */
+namespace
+{
+    using namespace lsp;
+
+    static constexpr size_t LINK_SAMPLE_RATE    = 48000;
+    static constexpr size_t LINK_BLOCK_SIZE     = 64;
+    static constexpr size_t LINK_STEP           = LINK_BLOCK_SIZE * 188;    // Position of the link change [samples]
+    static constexpr size_t LINK_TRANSIENT      = 96;                       // Transient starts before the link change [samples]
+    static constexpr size_t LINK_LENGTH         = LINK_STEP + LINK_SAMPLE_RATE / 10;
+    static constexpr float  LINK_TOLERANCE      = 0.5f;                     // Allowed overshoot of the output [dB]
+}
+
+UTEST_BEGIN("limiter", link)
+
+    void test_step(bool gdec)
+    {
+        test::PluginHost h;
+        UTEST_ASSERT(h.init(&meta::limiter_stereo, LINK_SAMPLE_RATE, LINK_BLOCK_SIZE) == STATUS_OK);
+
+        h.set_value("ovs", meta::limiter_metadata::OVS_NONE);
+        h.set_value("dith", meta::limiter_metadata::DITHER_NONE);
+        h.set_value("gdec", (gdec) ? 1.0f : 0.0f);
+        h.set_value("slink", 100.0f);
+        h.update_settings();
+
+        // Quiet tone in the left channel, +12 dB tone burst in the right channel
+        const float w           = 2.0f * M_PI * 997.0f / LINK_SAMPLE_RATE;
+        const float threshold   = dspu::db_to_gain(LINK_TOLERANCE);
+        float peak[2]           = { 0.0f, 0.0f };
+
+        for (size_t offset=0; offset < LINK_LENGTH; offset += LINK_BLOCK_SIZE)
+        {
+            if (offset == LINK_STEP)
+            {
+                h.set_value("slink", 50.0f);
+                h.update_settings();
+            }
+
+            float *l                = h.input(0);
+            float *r                = h.input(1);
+            for (size_t i=0; i<LINK_BLOCK_SIZE; ++i)
+            {
+                const size_t t          = offset + i;
+                const float s           = sinf(w * t);
+                l[i]                    = GAIN_AMP_M_20_DB * s;
+                r[i]                    = ((t + LINK_TRANSIENT) >= LINK_STEP) ? GAIN_AMP_P_12_DB * s : GAIN_AMP_M_20_DB * s;
+            }
+
+            h.process(LINK_BLOCK_SIZE);
+
+            for (size_t i=0; i<2; ++i)
+                peak[i]                 = lsp_max(peak[i], dsp::abs_max(h.output(i), LINK_BLOCK_SIZE));
+        }
+
+        for (size_t i=0; i<2; ++i)
+            UTEST_ASSERT_MSG(peak[i] <= threshold,
+                "Output of channel %d exceeds the threshold after the link change: %.2f dB (fast gain=%s)",
+                int(i), dspu::gain_to_db(peak[i]), (gdec) ? "on" : "off");
+    }
+
+    UTEST_MAIN
+    {
+        test_step(false);
+        test_step(true);
+    }
+
+UTEST_END